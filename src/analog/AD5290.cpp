@@ -21,118 +21,19 @@
 namespace AD5290 {
   using namespace AD5290Types;
 
-  // class constructor for AD5290 object
-  AD5290::AD5290(uint8_t spi_chip_select, uint32_t spi_bus_speed) : 
+  // class constructor for AD5290Bus object
+  AD5290Bus::AD5290Bus(uint8_t spi_chip_select, uint32_t spi_bus_speed) : 
     spi_chip_select(spi_chip_select), 
     spi_bus_speed((spi_bus_speed > AD5290_SPI_SPEEDMAXIMUM) ? AD5290_SPI_SPEEDMAXIMUM : spi_bus_speed),
-    number_of_devices(AD5290_MINIMUM_DEVICE_COUNT) {
-      this->wiper_data[this->number_of_devices] ={0U};
+    engine(nullptr),
+    shifting(false) {
       pinMode(this->spi_chip_select, OUTPUT);
       digitalWrite(this->spi_chip_select, HIGH);
       SPI.begin();
   }
-  AD5290::AD5290(uint8_t spi_chip_select, uint32_t spi_bus_speed, uint8_t number_of_devices) : 
-    spi_chip_select(spi_chip_select), 
-    spi_bus_speed((spi_bus_speed > AD5290_SPI_SPEEDMAXIMUM) ? AD5290_SPI_SPEEDMAXIMUM : spi_bus_speed),
-    number_of_devices((number_of_devices > AD5290_MINIMUM_DEVICE_COUNT) ? 
-                      ((number_of_devices < AD5290_MAXIMUM_DEVICE_COUNT) ? 
-                        number_of_devices : AD5290_MAXIMUM_DEVICE_COUNT) : AD5290_MINIMUM_DEVICE_COUNT) {
-      this->wiper_data[this->number_of_devices] ={0U};
-      pinMode(this->spi_chip_select, OUTPUT);
-      digitalWrite(this->spi_chip_select, HIGH);
-      SPI.begin();
-  }
-
-  // initialize and configure the device
-  bool AD5290::init(void) {
-    memset(this->wiper_data, AD5290_MIDPOINT_WIPER_VALUE, this->number_of_devices);
-
-    // configure SPI interface and begin the SPI transaction
-    this->beginTransaction();
-
-    // send readback value to ensure SPI is working, then set potentiometer value to midpoint value
-    uint8_t spi_received_value = 0xAA;
-    for (uint8_t idx = 0; idx < this->number_of_devices; idx++) {
-      SPI.transfer(0xAA);
-    }
-    for (uint8_t idx = 0; idx < this->number_of_devices; idx++) {
-      spi_received_value &= (uint8_t)SPI.transfer(this->wiper_data[idx]);
-    }
-
-    // end the SPI transaction and release the SPI bus
-    this->endTransaction();
-
-    // use the first SPI transaction during init to check if communication is working
-    if (spi_received_value != 0xAA) {
-      // indicates that the recieved data did not match the first transmitted byte
-      // if AD5290 CIPO back to microcontroller is unused, this can be safely ignored
-      return false;
-    }
-
-    // initialization was successful
-    return true;
-  }
-
-  // set a single potentiometer to a value between 0 [min] and 255 [max]
-  void AD5290::set(uint8_t value) {
-    // set digital potentiometer wiper to the specified value
-    this->wiper_data[0] = value;
-    this->beginTransaction();
-    SPI.transfer(this->wiper_data[0]);
-    this->endTransaction();
-  }
-
-  // set multiple potentiometers to a values between 0 [min] and 255 [max]
-  bool AD5290::set(uint8_t* array, size_t array_size) {
-    if (array_size != (size_t)this->number_of_devices) {
-      return false;
-    }
-
-    // set an array of digital potentiometers to the specified value
-    memcpy(this->wiper_data, &array, array_size);
-    this->beginTransaction();
-    for (uint8_t idx = 0; idx < this->number_of_devices; idx++) {
-      SPI.transfer(this->wiper_data[idx]);
-    }
-    this->endTransaction();
-
-    return true;
-  }
-
-  // read back the value of a single potentiometer
-  uint8_t AD5290::get(void) {
-    // get digital potentiometer wiper position
-    this->beginTransaction();
-    this->wiper_data[0] = (uint8_t)SPI.transfer(AD5290_MIDPOINT_WIPER_VALUE);
-    SPI.transfer(this->wiper_data[0]);
-    this->endTransaction();
-
-    return this->wiper_data[0];
-  }
-
-  // read back the values of multiple potentiometers
-  bool AD5290::get(uint8_t* array, size_t array_size) {
-    if ((uint8_t)array_size != this->number_of_devices) {
-      return false;
-    }
-
-    // get the full daisy-chain of digital potentiometer wiper positions
-    this->beginTransaction();
-    for (uint8_t idx = 0; idx < this->number_of_devices; idx++) {
-      this->wiper_data[idx] = (uint8_t)SPI.transfer(AD5290_MIDPOINT_WIPER_VALUE);
-    }
-    for (uint8_t idx = 0; idx < this->number_of_devices; idx++) {
-      (uint8_t)SPI.transfer(this->wiper_data[idx]);
-    }
-    this->endTransaction();
-    
-    memcpy(array, &this->wiper_data, array_size);
-
-    return true;
-  }
 
   // initialize the SPI interface and take ownership of SPI bus
-  void AD5290::beginTransaction(void) {
+  void AD5290Bus::beginTransaction(void) {
     SPI.beginTransaction(SPISettings(this->spi_bus_speed, 
                                      AD5290_SPI_DATAORDER, 
                                      AD5290_SPI_DATAMODE));
@@ -142,11 +43,42 @@ namespace AD5290 {
   }
 
   // end the SPI transaction and release ownership of SPI bus
-  void AD5290::endTransaction(void) {
+  void AD5290Bus::endTransaction(void) {
     // de-assert the SPI chip select pin to end SPI transaction
     digitalWrite(this->spi_chip_select, HIGH);
 
     // release ownership of the SPI bus
     SPI.endTransaction();
   }
+
+  // shift a buffer through the chain in a single buffered SPI transfer
+  void AD5290Bus::transfer(uint8_t *buffer, size_t size) {
+    SPI.transfer(buffer, size);
+  }
+
+  // shift a buffer through the chain, asynchronously if an engine is available
+  void AD5290Bus::shift(uint8_t *buffer, size_t size, bool async) {
+    shifting = true;
+    this->beginTransaction();
+
+#if AD5290_ASYNC_SPI_SUPPORTED
+    // the engine calls shiftComplete() to end the transaction once the chain is clocked
+    if (async && (this->engine != nullptr) && 
+        this->engine->start(buffer, size, &AD5290Bus::shiftComplete, this)) {
+      return;
+    }
+#else
+    (void)async;
+#endif
+
+    this->transfer(buffer, size);
+    shiftComplete(this);
+  }
+
+  // deassert chip select and release the SPI bus once a chain shift has completed
+  void AD5290Bus::shiftComplete(void *context) {
+    AD5290Bus *bus = static_cast<AD5290Bus *>(context);
+    bus->endTransaction();
+    bus->shifting = false;
+  }
 }
@@ -36,20 +36,122 @@
   #define AD5290_MINIMUM_DEVICE_COUNT ( 1U)
   #define AD5290_MAXIMUM_DEVICE_COUNT (16U)
 
+  // asynchronous chain shifts need an interrupt or DMA driven SPIEngine, on AVR the CPU
+  // clocks each byte anyway so shifts always use the blocking SPI.transfer() path
+  #if defined(__AVR__)
+    #define AD5290_ASYNC_SPI_SUPPORTED (false)
+  #else
+    #define AD5290_ASYNC_SPI_SUPPORTED (true )
+  #endif
+
   namespace AD5290 {
     namespace AD5290Types {
+      /*! @brief Called when an SPIEngine transfer completes, possibly from an interrupt */
+      typedef void (*transfer_callback_t)(void *context);
     }
 
-    class AD5290 {
+    /*! @brief Interface to an interrupt or DMA driven SPI peripheral
+    *
+    * @details Implemented per platform (or by a simulated peripheral in host tests) and
+    *          passed to `AD5290Bus::setEngine()`. The SPI bus is configured and chip select
+    *          asserted before `start()`, and released by the completion callback.
+    */
+    class SPIEngine {
+      public:
+        virtual ~SPIEngine() {}
+
+        /*! @brief  Start shifting a buffer out, replacing it in place with the data shifted in
+        *
+        * @param    buffer    The data to send, which must stay valid until completion
+        * @param    size      The number of bytes to send
+        * @param    complete  Called once when the last byte has been clocked
+        * @param    context   Passed to `complete`
+        * @returns  bool      'False' if the transfer could not be started
+        */
+        virtual bool start(uint8_t *buffer, size_t size, 
+                           AD5290Types::transfer_callback_t complete, void *context) = 0;
+    };
+
+    /*! @brief SPI chip select and transaction handling shared by every AD5290 chain length
+    *
+    * @details Kept out of the `AD5290<devices>` template so the bus code is compiled once
+    */
+    class AD5290Bus {
       public:
         /*! @brief Class constructor
         *
-        * @details A more elaborate description of the constructor.
+        * @details Configure the chip select pin and start the SPI interface
         * 
         * @param spi_chip_select The Arduino pin used as SPI Chip Select (CS) for the physical device
+        * @param spi_bus_speed   The SPI clock speed, limited to AD5290_SPI_SPEEDMAXIMUM
         */
-        AD5290(uint8_t spi_chip_select, uint32_t spi_bus_speed);
-        AD5290(uint8_t spi_chip_select, uint32_t spi_bus_speed, uint8_t number_of_devices);
+        AD5290Bus(uint8_t spi_chip_select, uint32_t spi_bus_speed);
+
+        /*! @brief  Set the engine used for asynchronous chain shifts
+        *
+        * @param    engine  An SPIEngine, or nullptr to always use blocking transfers
+        */
+        void setEngine(SPIEngine *engine) { this->engine = engine; }
+
+        /*! @brief  'True' while an asynchronous chain shift is in progress */
+        bool busy(void) { return shifting; }
+
+      protected:
+        const uint8_t spi_chip_select;
+        const uint32_t spi_bus_speed;
+        SPIEngine *engine;
+        volatile bool shifting;
+
+        /*! @brief  Shift a buffer through the chain in its own SPI transaction
+        *
+        * @details With `async` set and an engine available the transfer is started and
+        *          chip select is deasserted from the completion callback, otherwise the
+        *          buffer is shifted with a blocking transfer before returning
+        */
+        void shift(uint8_t *buffer, size_t size, bool async);
+
+        /*! @brief  End the transaction of a completed chain shift */
+        static void shiftComplete(void *context);
+
+        /*! @brief  Take ownership of the SPI bus and assert chip select */
+        void beginTransaction(void);
+
+        /*! @brief  Deassert chip select and release the SPI bus */
+        void endTransaction(void);
+
+        /*! @brief  Shift a buffer through the chain, replacing it with the data shifted out
+        *
+        * @details Must be called between `beginTransaction()` and `endTransaction()`
+        */
+        void transfer(uint8_t *buffer, size_t size);
+    };
+
+    /*! @brief A single AD5290, or a daisy-chain of `devices` AD5290 sharing chip select
+    *
+    * @details The wiper data of the whole chain is stored inline, so a chain needs no heap
+    *          and is sized at compile time. Position 0 is the first byte shifted out.
+    */
+    template <uint8_t devices = AD5290_MINIMUM_DEVICE_COUNT>
+    class AD5290 : public AD5290Bus {
+      static_assert((devices >= AD5290_MINIMUM_DEVICE_COUNT) && (devices <= AD5290_MAXIMUM_DEVICE_COUNT),
+                    "AD5290 chain length must be between 1 and 16 devices");
+
+      public:
+        /*! @brief Class constructor
+        *
+        * @param spi_chip_select The Arduino pin used as SPI Chip Select (CS) for the physical device
+        * @param spi_bus_speed   The SPI clock speed, limited to AD5290_SPI_SPEEDMAXIMUM
+        */
+        AD5290(uint8_t spi_chip_select, uint32_t spi_bus_speed) : 
+          AD5290Bus(spi_chip_select, spi_bus_speed), 
+          wiper_data{0U},
+          wiper_shifted{0U},
+          frame{0U},
+          frame_sent{0U},
+          pending(0),
+          in_flight(false),
+          verify(false),
+          verify_errors(0) { }
 
         /*! @brief Initialize the AD5290
         *
@@ -62,9 +164,10 @@
         */
         bool init(void);
 
-        /*! @brief Set the wiper position of a single AD5290
+        /*! @brief Set the wiper position of every AD5290 in the chain
         *
-        * @details Write data to the wiper value register via SPI to a single AD5290
+        * @details Write data to the wiper value register via SPI, for a single AD5290 this
+        *          is the only device. Nothing is sent if every wiper already has the value.
         * 
         * @param   value    The value to programmably set the potentiometer value [0-255]
         * @returns void
@@ -73,26 +176,86 @@
 
         /*! @brief Set the wiper position of multiple daisy-chained AD5290
         *
-        * @details Write data to the wiper value register via SPI to a multiple AD5290
+        * @details Write data to the wiper value register via SPI to a multiple AD5290,
+        *          nothing is sent if every wiper already has its value
         * 
         * @param    array       An array of values to programmably set the potentiometer [0-255]
         * @param    array_size  The size of the array as returned by sizeof()
         * @returns  bool        'True' if the operation was successful
         */
-        bool set(uint8_t* array, size_t array_size);
+        bool set(const uint8_t* array, size_t array_size);
+
+        /*! @brief Queue a new wiper position for one AD5290 in the chain
+        *
+        * @details The chain is not written until `flush()`, so several channels can be
+        *          changed with a single chain shift
+        * 
+        * @param    channel   The position of the device in the chain
+        * @param    value     The value to programmably set the potentiometer value [0-255]
+        * @returns  bool      'True' if the channel is within the chain
+        */
+        bool setChannel(uint8_t channel, uint8_t value);
+
+        /*! @brief Queue new wiper positions for the channels selected by a mask
+        *
+        * @details The chain is not written until `flush()`
+        * 
+        * @param    mask        A bit for each channel to change, bit 0 = channel 0
+        * @param    array       An array with a value for every channel of the chain, only
+        *                       the masked channels are used
+        * @param    array_size  The size of the array as returned by sizeof()
+        * @returns  bool        'True' if the operation was successful
+        */
+        bool setMany(uint16_t mask, const uint8_t* array, size_t array_size);
+
+        /*! @brief Shift the queued wiper positions through the chain
+        *
+        * @details Every device is written in one chain shift if any channel changed,
+        *          otherwise nothing is sent. In verify mode the bytes shifted out of the
+        *          chain are compared with the previous chain contents.
+        * 
+        * @returns  bool   'False' if verification of the shifted out bytes failed
+        */
+        bool flush(void);
 
-        /*! @brief Get the wiper position of a single AD5290
+        /*! @brief Start shifting the queued wiper positions through the chain
         *
-        * @details Read data via SPI from the wiper value register of a single AD5290
+        * @details Returns straight away while an SPIEngine clocks the chain, see
+        *          `AD5290Bus::setEngine()`. Without an engine, or on AVR, the shift blocks
+        *          like `flush()`. Verification results are counted by `verifyErrors()`.
+        * 
+        * @returns  bool   'False' if the previous shift is still in progress
+        */
+        bool flushAsync(void);
+
+        /*! @brief Compare the bytes shifted out by each `flush()` with the previous chain data
+        *
+        * @details Needs the chain SDO connected back to the microcontroller CIPO
+        */
+        void setVerify(bool enable) { verify = enable; }
+
+        /*! @brief  Number of flushes whose shifted out bytes did not match, see `setVerify()` */
+        uint16_t verifyErrors(void) { return verify_errors; }
+
+        /*! @brief Get the wiper position of the first AD5290
+        *
+        * @details Returned from the cached chain state, without bus traffic
         * 
         * @param    void
-        * @returns  uint8_t   The register value read back from a single AD5290
+        * @returns  uint8_t   The wiper position of the first AD5290
         */
         uint8_t get(void);
 
+        /*! @brief Get the wiper position of one AD5290 in the chain, without bus traffic
+        *
+        * @param    channel   The position of the device in the chain
+        * @returns  uint8_t   The wiper position, including changes not yet flushed
+        */
+        uint8_t getChannel(uint8_t channel);
+
         /*! @brief Get the wiper position of multiple daisy-chained AD5290
         *
-        * @details Read data via SPI from the wiper value register of multiple daisy-chained AD5290
+        * @details Copied from the cached chain state, without bus traffic
         * 
         * @param    array       An array to store values read from the daisy-chained AD5290
         * @param    array_size  The size of the array as returned by sizeof()
@@ -101,23 +264,190 @@
         bool get(uint8_t* array, size_t array_size);
 
       private:
-        const uint8_t spi_chip_select;
-        const uint32_t spi_bus_speed;
-        const uint8_t number_of_devices;
-        uint8_t wiper_data[];
+        // the authoritative wiper positions, and the data last shifted into the chain
+        uint8_t wiper_data[devices];
+        uint8_t wiper_shifted[devices];
 
-        /*! @brief  Initialize the AD5290
-        *
-        * @details Initialize the device and write default config values to all registers
-        */
-        void beginTransaction(void);
+        // the frame being shifted, replaced in place by the data shifted out, and a copy
+        // of the wiper data it was built from
+        uint8_t frame[devices];
+        uint8_t frame_sent[devices];
 
-        /*! @brief  Initialize the AD5290
-        *
-        * @details Initialize the device and write default config values to all registers
-        */
-        void endTransaction(void);
+        // a bit for each channel changed since the last flush, bit 0 = channel 0
+        uint16_t pending;
+        bool     in_flight;
+
+        bool     verify;
+        uint16_t verify_errors;
+
+        void     startShift(bool async);
+        bool     finishShift(void);
     };
+
+    // initialize and configure the device
+    template <uint8_t devices>
+    bool AD5290<devices>::init(void) {
+      while (this->busy()) {
+        // wait for an asynchronous shift still in progress
+      }
+      in_flight = false;
+      memset(this->wiper_data, AD5290_MIDPOINT_WIPER_VALUE, devices);
+
+      // send readback value to ensure SPI is working, then set potentiometer value to
+      // midpoint value, the readback value is shifted out as the wiper data is shifted in
+      uint8_t buffer[devices << 1];
+      memset(buffer, 0xAA, devices);
+      memcpy(&buffer[devices], this->wiper_data, devices);
+
+      this->beginTransaction();
+      this->transfer(buffer, sizeof(buffer));
+      this->endTransaction();
+      memcpy(this->wiper_shifted, this->wiper_data, devices);
+      pending = 0;
+
+      // use the first SPI transaction during init to check if communication is working
+      uint8_t spi_received_value = 0xAA;
+      for (uint8_t idx = devices; idx < sizeof(buffer); idx++) {
+        spi_received_value &= buffer[idx];
+      }
+      if (spi_received_value != 0xAA) {
+        // indicates that the recieved data did not match the first transmitted byte
+        // if AD5290 CIPO back to microcontroller is unused, this can be safely ignored
+        return false;
+      }
+
+      // initialization was successful
+      return true;
+    }
+
+    // set every potentiometer to a value between 0 [min] and 255 [max]
+    template <uint8_t devices>
+    void AD5290<devices>::set(uint8_t value) {
+      for (uint8_t idx = 0; idx < devices; idx++) {
+        this->setChannel(idx, value);
+      }
+      this->flush();
+    }
+
+    // set multiple potentiometers to a values between 0 [min] and 255 [max]
+    template <uint8_t devices>
+    bool AD5290<devices>::set(const uint8_t* array, size_t array_size) {
+      if (!this->setMany((uint16_t)((1UL << devices) - 1), array, array_size)) {
+        return false;
+      }
+      this->flush();
+
+      return true;
+    }
+
+    // queue a new value for a single potentiometer of the chain
+    template <uint8_t devices>
+    bool AD5290<devices>::setChannel(uint8_t channel, uint8_t value) {
+      if (channel >= devices) {
+        return false;
+      }
+      if (this->wiper_data[channel] != value) {
+        this->wiper_data[channel] = value;
+        pending |= (uint16_t)(1U << channel);
+      }
+      return true;
+    }
+
+    // queue new values for the masked potentiometers of the chain
+    template <uint8_t devices>
+    bool AD5290<devices>::setMany(uint16_t mask, const uint8_t* array, size_t array_size) {
+      if (array_size != (size_t)devices) {
+        return false;
+      }
+      for (uint8_t idx = 0; idx < devices; idx++) {
+        if (mask & (1U << idx)) {
+          this->setChannel(idx, array[idx]);
+        }
+      }
+      return true;
+    }
+
+    // shift the whole chain once if any potentiometer changed, blocking until it's done
+    template <uint8_t devices>
+    bool AD5290<devices>::flush(void) {
+      while (this->busy()) {
+        // wait for an asynchronous shift still in progress
+      }
+      bool verified = this->finishShift();
+
+      if (pending != 0) {
+        this->startShift(false);
+        verified = this->finishShift() && verified;
+      }
+      return verified;
+    }
+
+    // start shifting the whole chain if any potentiometer changed, without blocking
+    template <uint8_t devices>
+    bool AD5290<devices>::flushAsync(void) {
+      if (this->busy()) {
+        return false;   // the previous shift is still in progress, try again later
+      }
+      this->finishShift();
+
+      if (pending != 0) {
+        this->startShift(true);
+      }
+      return true;
+    }
+
+    // copy the wiper data to the frame buffer and start shifting it through the chain
+    template <uint8_t devices>
+    void AD5290<devices>::startShift(bool async) {
+      // the frame is overwritten with the data shifted out, so keep a copy of what was sent
+      memcpy(this->frame, this->wiper_data, devices);
+      memcpy(this->frame_sent, this->wiper_data, devices);
+      pending = 0;
+      in_flight = true;
+      this->shift(this->frame, devices, async);
+    }
+
+    // verify and record a completed shift, the bytes shifted out are the chain contents
+    // from the previous shift
+    template <uint8_t devices>
+    bool AD5290<devices>::finishShift(void) {
+      if (!in_flight) {
+        return true;
+      }
+      in_flight = false;
+
+      bool verified = !verify || (memcmp(this->frame, this->wiper_shifted, devices) == 0);
+      if (!verified) {
+        verify_errors++;
+      }
+      memcpy(this->wiper_shifted, this->frame_sent, devices);
+
+      return verified;
+    }
+
+    // return the cached value of the first potentiometer
+    template <uint8_t devices>
+    uint8_t AD5290<devices>::get(void) {
+      return this->wiper_data[0];
+    }
+
+    // return the cached value of one potentiometer
+    template <uint8_t devices>
+    uint8_t AD5290<devices>::getChannel(uint8_t channel) {
+      return (channel < devices) ? this->wiper_data[channel] : AD5290_MINIMUM_WIPER_VALUE;
+    }
+
+    // return the cached values of every potentiometer
+    template <uint8_t devices>
+    bool AD5290<devices>::get(uint8_t* array, size_t array_size) {
+      if (array_size != (size_t)devices) {
+        return false;
+      }
+
+      memcpy(array, this->wiper_data, devices);
+
+      return true;
+    }
   }
 
 #endif
@@ -0,0 +1,90 @@
+/*
+ * AutoVolume.cpp - Automatic Volume Control for MSGEQ7 and MAX9744 for Arduino
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AutoVolume.h"
+
+namespace AutoVolume {
+  // class constructor for AutoVolume object
+  AutoVolume::AutoVolume(MAX9744::MAX9744 &amplifier, uint16_t nominal_zero_signal_level) :
+    amplifier(amplifier),
+    nominal_zero_signal_level(nominal_zero_signal_level),
+    volume_map{0U},
+    level_current(0),
+    volume_current(0xFF),
+    write_count(0) { }
+
+  // rebuild the volume map and base level, then write the centre volume of the map
+  bool AutoVolume::setVolume(const uint8_t volume, const uint16_t base_level) {
+    if (volume > MAX9744_MAXIMUM_VOL_LEVEL) {
+      // the volume map can't be built, so leave the map and amplifier unchanged
+      return false;
+    }
+    amplifier.mapVolumeToBoundedRange(volume, volume_map, sizeof(volume_map));
+    amplifier.setRelativeBaseLevel(base_level);
+    levels.fill(base_level);
+    level_current = base_level;
+    this->apply(volume_map[DB_FAST_COEFFICIENT_COUNT >> 1]);
+    return true;
+  }
+
+  // update the control loop with a new frame, return true if the volume was written
+  bool AutoVolume::update(const uint16_t read_array[], const size_t array_size) {
+    if ((uint16_t)array_size != (uint16_t)14) {
+      // there are 7 spectral bands so the array size must be 14 bytes
+      // if this is not the case then don't do anything and return false
+      return false;
+    }
+
+    // mean level of the frame, much faster than divide-by-7, accurate to 7.00
+    uint32_t sum = 0;
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      sum = sum + read_array[k];
+    }
+    uint16_t frame_mean = (uint16_t)((sum * 585UL) >> 12);
+
+    level_current = levels.update(frame_mean, nominal_zero_signal_level);
+    uint8_t index = amplifier.getVolumeMapIndx(level_current);
+    return this->apply(volume_map[index]);
+  }
+
+  // return the volume setting most recently written to the amplifier
+  uint8_t AutoVolume::volume(void) {
+    return volume_current;
+  }
+
+  // return the smoothed audio level the volume was chosen from
+  uint16_t AutoVolume::level(void) {
+    return level_current;
+  }
+
+  // return the number of volume writes issued to the amplifier
+  uint32_t AutoVolume::writes(void) {
+    return write_count;
+  }
+
+  // write a volume to the amplifier only if it differs from the last one written
+  bool AutoVolume::apply(const uint8_t value) {
+    if (value == volume_current) {
+      return false;
+    }
+    amplifier.volume(value);
+    volume_current = value;
+    write_count++;
+    return true;
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * AutoVolume.h - Automatic Volume Control for MSGEQ7 and MAX9744 for Arduino
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUTO_VOLUME_H
+#define AUTO_VOLUME_H
+
+  #include <Arduino.h>
+
+  #include "MAX9744.h"
+  #include "MSGEQ7.h"
+  #include "decaybuffer.h"
+
+  // number of frames averaged by the decaying level buffer, must be a power of two
+  #define AUTOVOLUME_LEVEL_BUFFER_SIZE (32U)
+
+  namespace AutoVolume {
+    /*! @brief Closed-loop automatic volume control from MSGEQ7 frames to a MAX9744
+    *
+    * @details Owns the level buffer and volume map that sketches used to wire together by
+    *          hand. Each frame is reduced to its mean level, smoothed by a decaying level
+    *          buffer, mapped to a volume map index by the log2 level estimator and hysteresis
+    *          of `MAX9744::getVolumeMapIndx()`, and the amplifier is only written when the
+    *          resulting volume setting actually changes.
+    */
+    class AutoVolume {
+      public:
+        /*! @brief Class constructor
+        *
+        * @param amplifier                  The MAX9744 whose volume is controlled
+        * @param nominal_zero_signal_level  The mean MSGEQ7 level measured with no signal present
+        */
+        AutoVolume(MAX9744::MAX9744 &amplifier, uint16_t nominal_zero_signal_level);
+
+        /*! @brief  Set the user volume and the audio level it applies to
+        *
+        * @details Rebuilds the volume map around `volume`, sets the amplifier base
+        *          level to `base_level`, and writes the centre volume of the map
+        * 
+        * @param    volume      The user volume setting (0-63)
+        * @param    base_level  The mean audio level at which `volume` is used unchanged
+        * @returns  bool        'False' if `volume` is out of range and nothing was changed
+        */
+        bool     setVolume(const uint8_t volume, const uint16_t base_level);
+
+        /*! @brief  Update the control loop with a new frame
+        *
+        * @param    array_values  A frame of seven band levels, e.g. from `MSGEQ7::read()`
+        * @param    array_size    The size of the array as returned by sizeof()
+        * @returns  bool          'True' if a new volume was written to the amplifier
+        */
+        bool     update(const uint16_t array_values[], const size_t array_size);
+
+        /*! @brief  The volume setting most recently written to the amplifier */
+        uint8_t  volume(void);
+
+        /*! @brief  The smoothed audio level the volume was chosen from */
+        uint16_t level(void);
+
+        /*! @brief  Number of volume writes issued to the amplifier */
+        uint32_t writes(void);
+
+      private:
+        MAX9744::MAX9744 &amplifier;
+        const uint16_t nominal_zero_signal_level;
+
+        DecayBuffer::DecayBuffer<AUTOVOLUME_LEVEL_BUFFER_SIZE> levels;
+        uint8_t  volume_map[DB_FAST_COEFFICIENT_COUNT];
+
+        uint16_t level_current;
+        uint8_t  volume_current;
+        uint32_t write_count;
+
+        bool     apply(const uint8_t value);
+    };
+  }
+
+#endif
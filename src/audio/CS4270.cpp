@@ -22,10 +22,13 @@ namespace CS4270 {
   using namespace CS4270Types;
 
   // class constructor for CS4270 object
-  CS4270::CS4270(uint8_t i2c_address, uint8_t enable_n, TwoWire* pWire) : 
+  CS4270::CS4270(uint8_t i2c_address, uint8_t enable_n, TwoWire* pWire, 
+                 const config_t &config) : 
     i2c_address(i2c_address), 
     reset_n(enable_n), 
-    channel_attenuation{0U} {
+    config(config),
+    registers(registerImage(config)),
+    dirty(0) {
     this->shutdown();
     this->pWire = pWire;
   }
@@ -40,73 +43,23 @@ namespace CS4270 {
     digitalWrite(reset_n, LOW);
     delayMicroseconds(100);
 
-    // set PDN bit to put CS4270 in standby
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_PWR_CTRL);
-      this->pWire->write(0x01);
-    twi_error_type_t error = (twi_error_type_t)this->pWire->endTransmission();
+    // build the register image for PWR_CTRL through DAC_VOLB, with the PDN bit set so
+    // the CS4270 stays in standby while it is configured
+    registers = registerImage(config);
+    registers.value[CS4270_PWR_CTRL - CS4270_PWR_CTRL] = 0x01;
+
+    // write every register in a single auto-increment burst starting at PWR_CTRL
+    dirty = (uint8_t)((1U << CS4270_REGISTER_COUNT) - 1);
+    twi_error_type_t error = this->flush();
       
     // use the first TwoWire transaction during init to check if communication is working
     if (error == NACK_ADDRESS) {
       return false;
     }
 
-    // configure Mode Control register
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_MDE_CTRL);
-      this->pWire->write(0x01);
-    this->pWire->endTransmission();
-
-    // configure ADC and DAC control
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_ADDACTRL);
-      if (CS4270_LOOPBACK) {
-        this->pWire->write(0x29);
-      }
-      else {
-        this->pWire->write(0x09);
-      }
-    this->pWire->endTransmission();
-
-    // configure Transition Control register
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_TRN_CTRL);
-      if (CS4270_DEEMPHAS) {
-        this->pWire->write(0xF1);
-      }
-      else {
-        this->pWire->write(0xF0);
-      }
-    this->pWire->endTransmission();
-
-    // configure Mute Control register
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_MTE_CTRL);
-      if (CS4270_AUTOMUTE) {
-        this->pWire->write(0x20);
-      }
-      else {
-        this->pWire->write(0x00);
-      }
-    this->pWire->endTransmission();
-
-    // set DAC Channel A volume control
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_DAC_VOLA);
-      this->pWire->write(0x00);
-    this->pWire->endTransmission();
-
-    // set DAC Channel B volume control
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_DAC_VOLB);
-      this->pWire->write(0x00);
-    this->pWire->endTransmission();
-
     // clear PDN bit to take CS4270 out of standby
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_PWR_CTRL);
-      this->pWire->write(0x00);
-    this->pWire->endTransmission();
+    this->setRegister(CS4270_PWR_CTRL, 0x00);
+    this->flush();
 
     // initialization was successful
     return true;
@@ -122,70 +75,107 @@ namespace CS4270 {
     digitalWrite(reset_n, LOW);
   }
 
-  // mute the CS4270 output by setting maximum attenuation
+  // mute the CS4270 ADC and DAC outputs, leaving the auto-mute setting as configured
   void CS4270::mute(void) {
-    // Mute Control register for both ADC and DAC
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_MTE_CTRL);
-      this->pWire->write(0x1A);
-    this->pWire->endTransmission();
+    this->setRegister(CS4270_MTE_CTRL, this->getRegister(CS4270_MTE_CTRL) | CS4270_MUTE_BITS);
+    this->flush();
   }
 
-  // unmute the CS4270 amplifier by restoring previous attenuation
+  // unmute the CS4270 ADC and DAC outputs, leaving the auto-mute setting as configured
   void CS4270::unmute(void) {
-    // Mute Control register for both ADC and DAC
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(CS4270_MTE_CTRL);
-      this->pWire->write(0x00);
-    this->pWire->endTransmission();
+    this->setRegister(CS4270_MTE_CTRL, this->getRegister(CS4270_MTE_CTRL) & (uint8_t)~CS4270_MUTE_BITS);
+    this->flush();
   }
 
-  // set the potentiometers to a value between 0 [min] and 63 [max]
+  // set the DAC channel attenuation to a value between 0 [min] and 127 [max]
   void CS4270::volume(uint8_t value, channels_t channel) {
-    // if the value and channel are within allowable range
-    if ((value >= CS4270_MINIMUM_ATTENUATION) &&
-        (value <= CS4270_MAXIMUM_ATTENUATION)) {
-      
-      switch (channel) {
-        case Mono_ChA: {
-          channel_attenuation[0] = value;
-
-          //  set DAC Channel A volume control
-          this->pWire->beginTransmission(i2c_address);
-            this->pWire->write(CS4270_DAC_VOLA);
-            this->pWire->write(0x00);
-          this->pWire->endTransmission();
-        }
-        break;
-
-        case Mono_ChB: {
-          channel_attenuation[1] = value;
-
-          //  set DAC Channel B volume control
-          this->pWire->beginTransmission(i2c_address);
-            this->pWire->write(CS4270_DAC_VOLB);
-            this->pWire->write(0x00);
-          this->pWire->endTransmission();
-        }
-        break;
-
-        case Stereo: {
-          memset(channel_attenuation, value, sizeof(channel_attenuation));
-
-          //  set DAC Channel A volume control
-          this->pWire->beginTransmission(i2c_address);
-            this->pWire->write(CS4270_DAC_VOLA);
-            this->pWire->write(0x00);
-          this->pWire->endTransmission();
-
-          //  set DAC Channel B volume control
-          this->pWire->beginTransmission(i2c_address);
-            this->pWire->write(CS4270_DAC_VOLB);
-            this->pWire->write(0x00);
-          this->pWire->endTransmission();
-        }
-        break;
+    // if the value is within allowable range
+    if (value <= CS4270_MAXIMUM_ATTENUATION) {
+      if (channel != Mono_ChB) {
+        this->setRegister(CS4270_DAC_VOLA, value);
+      }
+      if (channel != Mono_ChA) {
+        this->setRegister(CS4270_DAC_VOLB, value);
       }
+
+      // stereo is a single burst to VOLA and VOLB
+      this->flush();
+    }
+  }
+
+  // return a DAC channel attenuation from the register cache
+  uint8_t CS4270::getAttenuation(channels_t channel) {
+    return this->getRegister((channel == Mono_ChB) ? CS4270_DAC_VOLB : CS4270_DAC_VOLA);
+  }
+
+  // return the mute state from the register cache
+  bool CS4270::isMuted(void) {
+    return (this->getRegister(CS4270_MTE_CTRL) & CS4270_MUTE_BITS) == CS4270_MUTE_BITS;
+  }
+
+  // return a control register from the register cache
+  uint8_t CS4270::getRegister(uint8_t address) {
+    if ((address < CS4270_PWR_CTRL) || (address > CS4270_DAC_VOLB)) {
+      return 0x00;
+    }
+    return registers.value[address - CS4270_PWR_CTRL];
+  }
+
+  // write only the registers changed by a new configuration, in one auto-increment burst
+  bool CS4270::configure(const config_t &config) {
+    register_image_t image = registerImage(config);
+    this->config = config;
+
+    // the configuration registers lie between MDE_CTRL and MTE_CTRL, so PDN and volume
+    // are kept, as are the mute bits of MTE_CTRL
+    image.value[CS4270_MTE_CTRL - CS4270_PWR_CTRL] |= 
+      this->getRegister(CS4270_MTE_CTRL) & CS4270_MUTE_BITS;
+    for (uint8_t address = CS4270_MDE_CTRL; address <= CS4270_MTE_CTRL; address++) {
+      this->setRegister(address, image.value[address - CS4270_PWR_CTRL]);
+    }
+    return (this->flush() == NO_ERROR);
+  }
+
+  // return the configuration most recently written to the device
+  config_t CS4270::getConfig(void) {
+    return config;
+  }
+
+  // set a register in the cache, and mark it dirty if its value changed
+  void CS4270::setRegister(uint8_t address, uint8_t value) {
+    uint8_t k = address - CS4270_PWR_CTRL;
+    if (registers.value[k] != value) {
+      registers.value[k] = value;
+      dirty |= (uint8_t)(1U << k);
+    }
+  }
+
+  // write every dirty register, from the first to the last, in one auto-increment burst
+  twi_error_type_t CS4270::flush(void) {
+    if (dirty == 0) {
+      return NO_ERROR;   // the device already matches the register cache
+    }
+
+    uint8_t first = 0;
+    while (!(dirty & (1U << first))) {
+      first++;
+    }
+    uint8_t last = CS4270_REGISTER_COUNT - 1;
+    while (!(dirty & (1U << last))) {
+      last--;
+    }
+
+    // clean registers between the first and last are rewritten with their cached value
+    this->pWire->beginTransmission(i2c_address);
+      this->pWire->write(CS4270_MAP_INCR | (CS4270_PWR_CTRL + first));
+      this->pWire->write(&registers.value[first], (last - first) + 1);
+    twi_error_type_t error = (twi_error_type_t)this->pWire->endTransmission();
+
+    // only a successful write brings the device in line with the cache, otherwise the
+    // registers stay dirty so the next flush writes them again
+    if (error == NO_ERROR) {
+      dirty = 0;
     }
+    return error;
   }
 }
@@ -29,7 +29,7 @@
   #define CS4270_MINIMUM_ATTENUATION  (  0U)
   #define CS4270_MAXIMUM_ATTENUATION  (127U)
 
-  // define the CS4270 configuration register options
+  // define the default CS4270 configuration register options, see CS4270Types::config_t
   #define CS4270_LOOPBACK (true )
   #define CS4270_DEEMPHAS (false)
   #define CS4270_AUTOMUTE (false)
@@ -45,6 +45,12 @@
   #define CS4270_DAC_VOLB (0x08) //DAC Channel B volume
   #define CS4270_MAP_INCR (0x80) //I2C MAP auto-increment
 
+  // number of writable control registers, PWR_CTRL (0x02) through DAC_VOLB (0x08)
+  #define CS4270_REGISTER_COUNT (7U)
+
+  // Mute Control register bits set by mute(), the auto-mute bit is left as configured
+  #define CS4270_MUTE_BITS      (0x1A)
+
   namespace CS4270 {
     namespace CS4270Types {
       /*! @enum TwoWire error types */
@@ -56,6 +62,38 @@
         OTHER, 
         TIME_OUT
       };
+
+      /*! @struct Configuration register options, mapped to registers by `registerImage()` */
+      struct config_t {
+        bool loopback;      // digital loopback from ADC to DAC
+        bool deemphasis;    // 44.1 kHz de-emphasis filter
+        bool automute;      // DAC auto-mute after 8192 consecutive zero samples
+      };
+
+      /*! @struct Register values of PWR_CTRL (0x02) through DAC_VOLB (0x08) */
+      struct register_image_t {
+        uint8_t value[CS4270_REGISTER_COUNT];
+      };
+
+      // configuration set by the CS4270_LOOPBACK, CS4270_DEEMPHAS and CS4270_AUTOMUTE defines
+      constexpr config_t default_config = { CS4270_LOOPBACK, CS4270_DEEMPHAS, CS4270_AUTOMUTE };
+    }
+
+    /*! @brief  Build the register image of a configuration, with PDN clear and volume at 0 dB
+    *
+    * @details Evaluated at compile time for a constant configuration (e.g.
+    *          `CS4270Types::default_config`), or once at runtime by `CS4270::configure()`
+    */
+    constexpr CS4270Types::register_image_t registerImage(const CS4270Types::config_t config) {
+      return CS4270Types::register_image_t {{
+        (uint8_t)0x00,                                // PWR_CTRL
+        (uint8_t)0x01,                                // MDE_CTRL
+        (uint8_t)(config.loopback   ? 0x29 : 0x09),   // ADDACTRL
+        (uint8_t)(config.deemphasis ? 0xF1 : 0xF0),   // TRN_CTRL
+        (uint8_t)(config.automute   ? 0x20 : 0x00),   // MTE_CTRL
+        (uint8_t)0x00,                                // DAC_VOLA
+        (uint8_t)0x00                                 // DAC_VOLB
+      }};
     }
 
     class CS4270 {
@@ -74,12 +112,15 @@
         * @param i2c_address The physical device's I2C address
         * @param reset_n     The microcontroller pin connected to the device RESET_L next
         * @param pWire       A pointer to an instance of the TwoWire class
+        * @param config      The configuration written by `init()`
         */
-        CS4270(uint8_t i2c_address, uint8_t reset_n, TwoWire *pWire);
+        CS4270(uint8_t i2c_address, uint8_t reset_n, TwoWire *pWire, 
+               const CS4270Types::config_t &config = CS4270Types::default_config);
 
         /*! @brief  Initialize the CS4270
         *
-        * @details Initialize the device and write default config values to all registers
+        * @details Initialize the device and write default config values to all registers,
+        *          as one auto-increment burst with PDN set followed by a write clearing PDN
         * 
         * @warning This will reset all device registers to the default configuration 
         */
@@ -125,10 +166,54 @@
         */
         void volume(uint8_t value, channels_t channel);
 
+        /*! @brief  The attenuation of a DAC channel from the register cache, without bus traffic
+        *
+        * @param channel   Mono_ChA or Mono_ChB, Stereo returns channel A
+        * @returns uint8_t The channel attenuation (0-127)
+        */
+        uint8_t getAttenuation(channels_t channel);
+
+        /*! @brief  'True' if the mute bits are set in the cached Mute Control register */
+        bool    isMuted(void);
+
+        /*! @brief  Read a control register from the cache, without bus traffic
+        *
+        * @details A value whose write failed stays cached and is written again by the
+        *          next mute, volume or configure call
+        * 
+        * @param address   A register address from CS4270_PWR_CTRL to CS4270_DAC_VOLB
+        * @returns uint8_t The last value set, or 0x00 for any other address
+        */
+        uint8_t getRegister(uint8_t address);
+
+        /*! @brief  Reconfigure a running CS4270
+        *
+        * @details Only the registers whose value changes are written, as a single
+        *          auto-increment burst from the first to the last changed register
+        * 
+        * @param config  The new configuration
+        * @returns bool  'False' if the burst was not acknowledged
+        */
+        bool configure(const CS4270Types::config_t &config);
+
+        /*! @brief  The configuration most recently written to the device */
+        CS4270Types::config_t getConfig(void);
+
       private:
         const uint8_t i2c_address;
         const uint8_t reset_n;
-        uint8_t channel_attenuation[2];
+
+        // configuration, the shadow of every control register, and a bit for each
+        // register (bit 0 = PWR_CTRL) changed in the shadow but not yet written
+        CS4270Types::config_t config;
+        CS4270Types::register_image_t registers;
+        uint8_t dirty;
+
+        // set a shadow register, marking it dirty if the value changed
+        void    setRegister(uint8_t address, uint8_t value);
+
+        // write the dirty registers in one auto-increment burst, they stay dirty on error
+        CS4270Types::twi_error_type_t flush(void);
         TwoWire *pWire;
     };
   }
@@ -25,7 +25,9 @@ namespace DS1882 {
   DS1882::DS1882(uint8_t i2c_address, uint8_t enable_n, TwoWire* pWire) : 
     i2c_address(i2c_address), 
     enable_n(enable_n), 
-    channel_attenuation{0U} {
+    channel_attenuation{0U},
+    registers{DS1882_CONFIGURATION, DS1882_COMMAND_POT0, DS1882_COMMAND_POT1},
+    registers_written{DS1882_REGISTER_UNKNOWN, DS1882_REGISTER_UNKNOWN, DS1882_REGISTER_UNKNOWN} {
     pinMode(this->enable_n, OUTPUT);
     this->shutdown();
     this->pWire = pWire;
@@ -41,16 +43,13 @@ namespace DS1882 {
     digitalWrite(this->enable_n, LOW);
     delayMicroseconds(100);
 
-    
-    
-    this->pWire->beginTransmission(this->i2c_address);
-      this->pWire->write(DS1882_CONFIGURATION);             // Configuration
-      this->pWire->write(0x00 + DS1882_MINIMUM_VOL_LEVEL);  // Potentiometer 0
-      this->pWire->write(0x40 + DS1882_MINIMUM_VOL_LEVEL);  // Potentiometer 1
-    twi_error_type_t error = (twi_error_type_t)this->pWire->endTransmission();
+    // the device state is unknown after reset, so write every register
+    memset(registers_written, DS1882_REGISTER_UNKNOWN, sizeof(registers_written));
+    registers[1] = DS1882_COMMAND_POT0 + DS1882_MINIMUM_VOL_LEVEL;   // Potentiometer 0
+    registers[2] = DS1882_COMMAND_POT1 + DS1882_MINIMUM_VOL_LEVEL;   // Potentiometer 1
 
     // use the TwoWire transactions during init to check if communication was successful
-    if (error == NACK_ADDRESS) {
+    if (!this->update()) {
       return false;
     }
 
@@ -71,86 +70,101 @@ namespace DS1882 {
   // mute the DS1882 by setting maximum attenuation
   bool DS1882::mute(void) {
     // Set Potentiometers volume to zero
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(0x00 + DS1882_MINIMUM_VOL_LEVEL);  // Potentiometer 0
-      this->pWire->write(0x40 + DS1882_MINIMUM_VOL_LEVEL);  // Potentiometer 1
-    this->pWire->endTransmission();
-    twi_error_type_t error = (twi_error_type_t)this->pWire->endTransmission();
-    
-    // use the TwoWire transaction to check if communication was successful
-    if (error == NACK_ADDRESS) {
-      return false;
-    }
-    return true;
+    registers[1] = DS1882_COMMAND_POT0 + DS1882_MINIMUM_VOL_LEVEL;   // Potentiometer 0
+    registers[2] = DS1882_COMMAND_POT1 + DS1882_MINIMUM_VOL_LEVEL;   // Potentiometer 1
+    return this->update();
   }
 
   // unmute the DS1882 amplifier by restoring previous attenuation
   bool DS1882::unmute(void) {
     // Set Potentiometers volume to current setting
-    this->pWire->beginTransmission(i2c_address);
-      this->pWire->write(0x00 + channel_attenuation[0]);  // Potentiometer 0
-      this->pWire->write(0x40 + channel_attenuation[1]);  // Potentiometer 1
-    twi_error_type_t error = (twi_error_type_t)this->pWire->endTransmission();
-    
-    // use the TwoWire transaction to check if communication was successful
-    if (error == NACK_ADDRESS) {
-      return false;
-    }
-    return true;
+    registers[1] = DS1882_COMMAND_POT0 + channel_attenuation[0];     // Potentiometer 0
+    registers[2] = DS1882_COMMAND_POT1 + channel_attenuation[1];     // Potentiometer 1
+    return this->update();
   }
 
   // set the potentiometers to a value between 0 [min] and 63 [max]
   bool DS1882::set(uint8_t value, channels_t channel) {
     // don't change anything if the value is not within allowable range
-    if ((value > DS1882_MAXIMUM_VOL_LEVEL)) {
+    if ((value > DS1882_MAXIMUM_VOL_LEVEL) || (channel > Stereo)) {
       return false;
     }
 
-    twi_error_type_t error;
+    if (channel != Mono_P1) {
+      channel_attenuation[0] = value;
+      registers[1] = DS1882_COMMAND_POT0 + value;
+    }
+    if (channel != Mono_P0) {
+      channel_attenuation[1] = value;
+      registers[2] = DS1882_COMMAND_POT1 + value;
+    }
 
-    switch (channel) {
-      case Mono_P0: {
-        channel_attenuation[0] = value;
+    // only the potentiometers that changed are written
+    return this->update();
+  }
 
-        // Set Potentiometer 0 volume to current setting
-        this->pWire->beginTransmission(i2c_address);
-          this->pWire->write(0x00 + channel_attenuation[0]);
-        error = (twi_error_type_t)this->pWire->endTransmission();
-      }
-      break;
+  // set each potentiometer to its own value between 0 [min] and 63 [max]
+  bool DS1882::set(uint8_t value_p0, uint8_t value_p1) {
+    // don't change anything if either value is not within allowable range
+    if ((value_p0 > DS1882_MAXIMUM_VOL_LEVEL) || (value_p1 > DS1882_MAXIMUM_VOL_LEVEL)) {
+      return false;
+    }
 
-      case Mono_P1: {
-        channel_attenuation[1] = value;
+    channel_attenuation[0] = value_p0;
+    channel_attenuation[1] = value_p1;
+    registers[1] = DS1882_COMMAND_POT0 + value_p0;
+    registers[2] = DS1882_COMMAND_POT1 + value_p1;
+    return this->update();
+  }
 
-        // Set Potentiometer 1 volume to current setting
-        this->pWire->beginTransmission(i2c_address);
-          this->pWire->write(0x40 + channel_attenuation[1]);
-        error = (twi_error_type_t)this->pWire->endTransmission();
-      }
-      break;
+  // enable or disable zero-crossing detection
+  bool DS1882::setZeroCrossing(bool enable) {
+    return this->setConfigurationBit(DS1882_CONFIG_ZERO_CROSS, enable);
+  }
 
-      case Stereo: {
-        memset(channel_attenuation, value, sizeof(channel_attenuation));
+  // use volatile or non-volatile wiper storage
+  bool DS1882::setVolatileStorage(bool enable) {
+    return this->setConfigurationBit(DS1882_CONFIG_VOLATILE, enable);
+  }
 
-        // Set Potentiometers volume to current setting
-        this->pWire->beginTransmission(i2c_address);
-          this->pWire->write(0x00 + channel_attenuation[0]);  // Potentiometer 0
-          this->pWire->write(0x40 + channel_attenuation[1]);  // Potentiometer 1
-        error = (twi_error_type_t)this->pWire->endTransmission();
-      }
-      break;
+  // return the configuration register from the register shadow
+  uint8_t DS1882::getConfiguration(void) {
+    return registers[0];
+  }
 
-      default: {
-        // set 'error' to NACK_ADDRESS so function still returns 'false'
-        error = NACK_ADDRESS;
-      }
-      break;
+  // set or clear a configuration register bit, and write it if it changed
+  bool DS1882::setConfigurationBit(uint8_t bit, bool enable) {
+    if (enable) {
+      registers[0] |= bit;
+    }
+    else {
+      registers[0] &= (uint8_t)~bit;
     }
+    return this->update();
+  }
 
-    // use the TwoWire transaction to check if communication was successful
-    if (error == NACK_ADDRESS) {
-      return false;
+  // write every command byte that differs from the device in a single transaction, the
+  // configuration goes first so a zero-crossing change applies to the wipers written with it
+  bool DS1882::update(void) {
+    if (memcmp(registers, registers_written, sizeof(registers)) == 0) {
+      return true;    // the device already matches the register shadow
+    }
+
+    this->pWire->beginTransmission(i2c_address);
+      for (uint8_t k = 0; k < sizeof(registers); k++) {
+        if (registers[k] != registers_written[k]) {
+          this->pWire->write(registers[k]);
+        }
+      }
+    twi_error_type_t error = (twi_error_type_t)this->pWire->endTransmission();
+
+    // use the TwoWire transaction to check if communication was successful, if it
+    // wasn't then the device state is unknown and every register is written next time
+    if (error != NO_ERROR) {
+      memset(registers_written, DS1882_REGISTER_UNKNOWN, sizeof(registers_written));
+      return (error != NACK_ADDRESS);
     }
+    memcpy(registers_written, registers, sizeof(registers));
     return true;
   }
 
@@ -39,9 +39,19 @@
   // potentiometer configuration option, must be set to 1
   #define POTENTIOMETER_CONFIG_OPTION ((uint8_t)1U)
 
-  // Combine configuration register options into one single value
+  // Combine configuration register options into one single value, this is the
+  // configuration written by init() and can be changed at runtime
   #define DS1882_CONFIGURATION (0x80 + (USE_VOLATILE_MEMORY_STORAGE << 2) + (ENABLE_ZERO_CROSSING_DETECT << 1) + (POTENTIOMETER_CONFIG_OPTION - 1))
 
+  // command byte prefixes and configuration register bits
+  #define DS1882_COMMAND_POT0      (0x00)
+  #define DS1882_COMMAND_POT1      (0x40)
+  #define DS1882_CONFIG_VOLATILE   (0x04)
+  #define DS1882_CONFIG_ZERO_CROSS (0x02)
+
+  // shadow value of a register whose device state is unknown, never a valid command byte
+  #define DS1882_REGISTER_UNKNOWN  (0xFF)
+
   namespace DS1882 {
     namespace DS1882Types {
       /*! @enum TwoWire error types */
@@ -131,6 +141,17 @@
         */
         bool set(uint8_t value, channels_t channel);
 
+        /*! @brief  Set both DS1882 potentiometers to different values
+        *
+        * @details Both potentiometers are written in a single transaction (or only the
+        *          one that changed), e.g. for a balance offset between channels
+        * 
+        * @param    value_p0  The desired potentiometer 0 setting (0-63)
+        * @param    value_p1  The desired potentiometer 1 setting (0-63)
+        * @returns  bool      'True' if the register write was successful
+        */
+        bool set(uint8_t value_p0, uint8_t value_p1);
+
         /*! @brief  Get the DS1882 volume and config register data
         *
         * @details Get volume level of the DS1882 for both channels, and the device configuration
@@ -140,11 +161,43 @@
         */
         bool get(uint8_t *array, size_t array_size);
 
+        /*! @brief  Enable or disable zero-crossing detection
+        *
+        * @details With zero-crossing detection enabled, wiper changes wait for a zero
+        *          crossing of the signal, so large steps don't click
+        * 
+        * @param    enable  'True' to enable zero-crossing detection
+        * @returns  bool    'True' if the register write was successful
+        */
+        bool setZeroCrossing(bool enable);
+
+        /*! @brief  Use volatile or non-volatile wiper storage
+        *
+        * @param    enable  'True' so wiper positions are not stored in EEPROM
+        * @returns  bool    'True' if the register write was successful
+        */
+        bool setVolatileStorage(bool enable);
+
+        /*! @brief  The configuration register value, from the register shadow */
+        uint8_t getConfiguration(void);
+
       private:
         const uint8_t i2c_address;
         const uint8_t enable_n;
         uint8_t channel_attenuation[2];
+
+        // command bytes (configuration, potentiometer 0, potentiometer 1) to be written,
+        // and the command bytes last written to the device
+        uint8_t registers[3];
+        uint8_t registers_written[3];
+
         TwoWire *pWire;
+
+        // write the command bytes that differ from the device in one transaction
+        bool update(void);
+
+        // set or clear a configuration register bit
+        bool setConfigurationBit(uint8_t bit, bool enable);
     };
   }
 
@@ -31,9 +31,17 @@ namespace MAX9744 {
     6492, 6876, 7284, 7715, 8173
   };
 
+  // log2(1 + k/16) as Q.8, for interpolating the fractional part of log2
+  static const uint16_t log2_fraction[LOG2_FRACTION_SEGMENTS + 1] PROGMEM =
+  {
+    0,   22,  44,  63,  82,  100, 118, 134,
+    150, 165, 179, 193, 207, 220, 232, 244,
+    256
+  };
+
   // MAX9744 amplifier gain levels (dB), stored as milli-Bells 
   // (1/100 of a dB) to allow PROGMEM storage as an int type
-  static const int16_t gain_milliBels[64] PROGMEM = 
+  static constexpr int16_t gain_milliBels[64] PROGMEM = 
   {
     -10950,  -9290,   -9030,   -8680,
     -8430,   -8080,   -7830,   -7470,
@@ -53,6 +61,100 @@ namespace MAX9744 {
     760,     820,     880,     950
   };
 
+  // lowest volume index whose gain is no more than MILLIBEL_BOUND_LOWER below `volume`
+  constexpr uint8_t volumeMapLowerBound(uint8_t volume, int16_t k) {
+    return (k < 0) ? 0 : 
+           (((gain_milliBels[k] - gain_milliBels[volume]) < MILLIBEL_BOUND_LOWER) ? 
+             (uint8_t)(k + 1) : volumeMapLowerBound(volume, k - 1));
+  }
+
+  // highest volume index whose gain is no more than MILLIBEL_BOUND_UPPER above `volume`
+  constexpr uint8_t volumeMapUpperBound(uint8_t volume, uint8_t k) {
+    return (k >= MAX9744_MAXIMUM_VOL_LEVEL) ? MAX9744_MAXIMUM_VOL_LEVEL : 
+           (((gain_milliBels[k] - gain_milliBels[volume]) > MILLIBEL_BOUND_UPPER) ? 
+             (uint8_t)(k - 1) : volumeMapUpperBound(volume, k + 1));
+  }
+
+  // gain of the `index`th volume counting down from `upper`, relative to the gain at `volume`
+  constexpr int16_t volumeMapGain(uint8_t volume, uint8_t upper, uint8_t index) {
+    return gain_milliBels[upper - index] - gain_milliBels[volume];
+  }
+
+  // advance the volume map index past map entry `k` if its gain step has been covered
+  constexpr uint8_t volumeMapStep(uint8_t volume, uint8_t lower, uint8_t upper, uint8_t k, 
+                                  uint8_t map_index, uint8_t skip_zero_index) {
+    return (((map_index + skip_zero_index) < ((upper - lower) + 1)) && 
+            ((MILLIBEL_BOUND_UPPER - volumeMapGain(volume, upper, map_index + skip_zero_index)) 
+              < (int16_t)(k * MILLIBEL_STEP_SIZE))) ? (uint8_t)(map_index + 1) : map_index;
+  }
+
+  constexpr uint8_t volumeMapWalk(uint8_t volume, uint8_t lower, uint8_t upper, uint8_t k, 
+                                  uint8_t target, uint8_t map_index, uint8_t skip_zero_index);
+
+  // walk map entries `k` to `target` once the skip-zero flag for entry `k` is known
+  constexpr uint8_t volumeMapWalkSkipped(uint8_t volume, uint8_t lower, uint8_t upper, uint8_t k, 
+                                         uint8_t target, uint8_t map_index, 
+                                         uint8_t skip_zero_index) {
+    return (k == target) ? 
+           volumeMapStep(volume, lower, upper, k, map_index, skip_zero_index) : 
+           volumeMapWalk(volume, lower, upper, k + 1, target, 
+                         volumeMapStep(volume, lower, upper, k, map_index, skip_zero_index), 
+                         skip_zero_index);
+  }
+
+  // walk map entries `k` to `target`, returning the volume map index used for `target`
+  constexpr uint8_t volumeMapWalk(uint8_t volume, uint8_t lower, uint8_t upper, uint8_t k, 
+                                  uint8_t target, uint8_t map_index, uint8_t skip_zero_index) {
+    return volumeMapWalkSkipped(volume, lower, upper, k, target, map_index, 
+                                (volumeMapGain(volume, upper, map_index) == 0) ? 
+                                  (uint8_t)1 : skip_zero_index);
+  }
+
+  constexpr uint8_t volumeMapEntry(uint8_t volume, uint8_t lower, uint8_t upper, uint8_t k) {
+    return upper - volumeMapWalk(volume, lower, upper, 0, k, 0, 0);
+  }
+
+  // volume setting for entry `k` of the volume map at `volume`, the same as the
+  // thresholds computed by mapVolumeToBoundedRange() but evaluated at compile time
+  constexpr uint8_t volumeMapEntry(uint8_t volume, uint8_t k) {
+    return volumeMapEntry(volume, 
+                          ((volume == MAX9744_MINIMUM_VOL_LEVEL) ? 
+                            (uint8_t)MAX9744_MINIMUM_VOL_LEVEL : 
+                            volumeMapLowerBound(volume, volume - 1)), 
+                          volumeMapUpperBound(volume, volume + 1), 
+                          k);
+  }
+
+#if MAX9744_PRECOMPUTE_VOLUME_MAPS
+  #define MAX9744_VOLUME_MAP(v) {                                                     \
+    volumeMapEntry(v,  0), volumeMapEntry(v,  1), volumeMapEntry(v,  2),              \
+    volumeMapEntry(v,  3), volumeMapEntry(v,  4), volumeMapEntry(v,  5),              \
+    volumeMapEntry(v,  6), volumeMapEntry(v,  7), volumeMapEntry(v,  8),              \
+    volumeMapEntry(v,  9), volumeMapEntry(v, 10), volumeMapEntry(v, 11),              \
+    volumeMapEntry(v, 12), volumeMapEntry(v, 13), volumeMapEntry(v, 14),              \
+    volumeMapEntry(v, 15), volumeMapEntry(v, 16), volumeMapEntry(v, 17),              \
+    volumeMapEntry(v, 18), volumeMapEntry(v, 19), volumeMapEntry(v, 20),              \
+    volumeMapEntry(v, 21), volumeMapEntry(v, 22), volumeMapEntry(v, 23),              \
+    volumeMapEntry(v, 24) }
+  #define MAX9744_VOLUME_MAPS_8(v)                                                    \
+    MAX9744_VOLUME_MAP(v + 0), MAX9744_VOLUME_MAP(v + 1), MAX9744_VOLUME_MAP(v + 2),  \
+    MAX9744_VOLUME_MAP(v + 3), MAX9744_VOLUME_MAP(v + 4), MAX9744_VOLUME_MAP(v + 5),  \
+    MAX9744_VOLUME_MAP(v + 6), MAX9744_VOLUME_MAP(v + 7)
+
+  // volume maps for every volume setting, evaluated at compile time and stored in PROGMEM
+  static constexpr uint8_t volume_maps[MAX9744_MAXIMUM_VOL_LEVEL + 1]
+                                      [DB_FAST_COEFFICIENT_COUNT] PROGMEM =
+  {
+    MAX9744_VOLUME_MAPS_8( 0), MAX9744_VOLUME_MAPS_8( 8), 
+    MAX9744_VOLUME_MAPS_8(16), MAX9744_VOLUME_MAPS_8(24), 
+    MAX9744_VOLUME_MAPS_8(32), MAX9744_VOLUME_MAPS_8(40), 
+    MAX9744_VOLUME_MAPS_8(48), MAX9744_VOLUME_MAPS_8(56)
+  };
+
+  #undef MAX9744_VOLUME_MAPS_8
+  #undef MAX9744_VOLUME_MAP
+#endif
+
   // class constructor for MAX9744 amplifier object
   MAX9744::MAX9744(uint8_t i2c_address, uint8_t mute_p, uint8_t shutdown_n, TwoWire *pWire) :
     i2c_address(i2c_address), 
@@ -60,7 +162,14 @@ namespace MAX9744 {
     shutdown_n(shutdown_n),
     invert_mute(false), 
     buffer_index(0),
-    vm_index_previous(DB_FAST_COEFFICIENT_COUNT >> 1) {
+    vm_index_previous(DB_FAST_COEFFICIENT_COUNT >> 1),
+    base_level(0),
+    base_milliBels(0),
+    volume_level(MAX9744_VOLUME_UNKNOWN),
+    volume_stats{0UL, 0UL, 0UL},
+    ramp_target(MAX9744_VOLUME_UNKNOWN),
+    ramp_slew(0),
+    ramp_timestamp(0) {
     this->shutdown();
     this->pWire = pWire;
   }
@@ -73,6 +182,10 @@ namespace MAX9744 {
     // mute the MAX9744 then take it out of shutdown
     this->mute();
     this->enable();
+
+    // the device volume is unknown after shutdown, so the next volume write can't be skipped
+    volume_level = MAX9744_VOLUME_UNKNOWN;
+    ramp_target = MAX9744_VOLUME_UNKNOWN;
       
     // use a TwoWire transaction during init to check if communication is working
     this->pWire->beginTransmission(i2c_address);
@@ -131,9 +244,101 @@ namespace MAX9744 {
     else if (value > MAX9744_MAXIMUM_VOL_LEVEL) {
       value = (uint8_t)MAX9744_MAXIMUM_VOL_LEVEL;
     }
+
+    // a direct volume change ends any ramp in progress
+    ramp_target = value;
+
+    // skip the write if the device already has this volume
+    if (value == volume_level) {
+      volume_stats.writes_skipped++;
+      volume_stats.bus_bytes_saved += MAX9744_VOLUME_WRITE_BYTES;
+      return;
+    }
+
     this->pWire->beginTransmission(i2c_address);
       this->pWire->write(value);
-    this->pWire->endTransmission();
+    twi_error_type_t error = (twi_error_type_t)(this->pWire->endTransmission());
+    volume_stats.writes++;
+
+    // only shadow the volume if the device acknowledged it, otherwise the device volume
+    // is unknown and the next write can't be skipped
+    if (error == NO_ERROR) {
+      volume_level = value;
+    }
+    else {
+      volume_level = MAX9744_VOLUME_UNKNOWN;
+    }
+  }
+
+  // start a non-blocking volume ramp towards `target`
+  void MAX9744::ramp(uint8_t target, uint16_t slew_milliBels) {
+    ramp_target = (target > MAX9744_MAXIMUM_VOL_LEVEL) ? MAX9744_MAXIMUM_VOL_LEVEL : target;
+    ramp_slew = slew_milliBels;
+    ramp_timestamp = millis();
+  }
+
+  // advance the volume ramp by as many steps as the slew rate allows, in a single write
+  bool MAX9744::tick(void) {
+    if (!this->ramping()) {
+      return false;
+    }
+
+    uint8_t target = ramp_target;
+    if ((volume_level == MAX9744_VOLUME_UNKNOWN) || (ramp_slew == 0)) {
+      // nothing to ramp from, or no slew limit, so go straight to the target
+      this->volume(target);
+      return true;
+    }
+
+    // time since the last ramp step, clamped to the time the rest of the ramp needs so the
+    // budget can't overflow when tick() hasn't been called for a while
+    int16_t gain_start = this->getGainAtVolumeIndex(volume_level);
+    uint16_t gain_remaining = abs(this->getGainAtVolumeIndex(target) - gain_start);
+    uint32_t elapsed = millis() - ramp_timestamp;
+    uint32_t elapsed_maximum = (((uint32_t)gain_remaining * 1000UL) / ramp_slew) + 1;
+    if (elapsed > elapsed_maximum) {
+      elapsed = elapsed_maximum;
+    }
+
+    // gain change allowed since the last ramp step
+    uint32_t budget = (elapsed * ramp_slew) / 1000UL;
+
+    // step towards the target while the total gain change stays within the budget
+    uint16_t gain_step = 0;
+    uint8_t next = volume_level;
+    while (next != target) {
+      uint8_t candidate = (next < target) ? (next + 1) : (next - 1);
+      uint16_t gain_delta = abs(this->getGainAtVolumeIndex(candidate) - gain_start);
+      if (gain_delta > budget) {
+        break;
+      }
+      next = candidate;
+      gain_step = gain_delta;
+    }
+    if (next == volume_level) {
+      return false;
+    }
+
+    // carry over the unused part of the budget to the next step
+    ramp_timestamp += ((uint32_t)gain_step * 1000UL) / ramp_slew;
+    this->volume(next);
+    ramp_target = target;
+    return true;
+  }
+
+  // check if a volume ramp is still in progress
+  bool MAX9744::ramping(void) {
+    return (ramp_target != MAX9744_VOLUME_UNKNOWN) && (ramp_target != volume_level);
+  }
+
+  // return the volume most recently written to the device
+  uint8_t MAX9744::getVolume(void) {
+    return volume_level;
+  }
+
+  // return the volume write statistics
+  volume_stats_t MAX9744::getVolumeStats(void) {
+    return volume_stats;
   }
 
   // return the dB gain values correllating amplifier volume settings
@@ -146,73 +351,127 @@ namespace MAX9744 {
                                       int16_t *values, const size_t values_size) {
     uint8_t index_minimum = ((start <= stop) ? start : stop);
     uint8_t index_maximum = ((start  > stop) ? start : stop);
-    if ((index_maximum - index_minimum) > values_size) {
+    size_t count = (size_t)(index_maximum - index_minimum) + 1;
+    if ((index_maximum > MAX9744_MAXIMUM_VOL_LEVEL) || (count > values_size)) {
       return;   // the `values[]` array is not large enough to contain the requested range
     }
-    else {
-      for (uint8_t k = 0; k <= values_size; k++) {
-        values[k] = this->getGainAtVolumeIndex(index_minimum + k);
+    memcpy_P(values, &gain_milliBels[index_minimum], count * sizeof(int16_t));
+  }
+
+  // set the amplifier gain to the volume setting nearest `milliBels`
+  void MAX9744::setGainMilliBels(int16_t milliBels, gain_rounding_t rounding) {
+    this->volume(this->getVolumeAtGain(milliBels, rounding));
+  }
+
+  // return the gain of the present volume setting
+  int16_t MAX9744::getGainMilliBels(void) {
+    if (volume_level == MAX9744_VOLUME_UNKNOWN) {
+      return MAX9744_GAIN_UNKNOWN;
+    }
+    return this->getGainAtVolumeIndex(volume_level);
+  }
+
+  // binary search the gain table for the volume setting nearest `milliBels`
+  uint8_t MAX9744::getVolumeAtGain(int16_t milliBels, gain_rounding_t rounding) {
+    // find the first volume setting with a gain at or above `milliBels`
+    uint8_t a = MAX9744_MINIMUM_VOL_LEVEL;
+    uint8_t b = MAX9744_MAXIMUM_VOL_LEVEL + 1;
+    while (a < b) {
+      uint8_t half = a + ((b - a) >> 1);
+      if (this->getGainAtVolumeIndex(half) < milliBels) {
+        a = half + 1;
+      }
+      else {
+        b = half;
       }
     }
+
+    // clamp gains outside the amplifier range
+    if (a == MAX9744_MINIMUM_VOL_LEVEL) {
+      return MAX9744_MINIMUM_VOL_LEVEL;
+    }
+    if (a > MAX9744_MAXIMUM_VOL_LEVEL) {
+      return MAX9744_MAXIMUM_VOL_LEVEL;
+    }
+
+    // `milliBels` is above the gain of `a - 1`, and at or below the gain of `a`
+    int16_t gain_above = this->getGainAtVolumeIndex(a);
+    if ((rounding == ROUND_UP) || (gain_above == milliBels)) {
+      return a;
+    }
+    if (rounding == ROUND_DOWN) {
+      return a - 1;
+    }
+    int16_t gain_below = this->getGainAtVolumeIndex(a - 1);
+    return ((gain_above - milliBels) < (milliBels - gain_below)) ? a : (a - 1);
   }
 
   // return a map of volume thresholds based on gain-to-volume levels at present volume setting
   void MAX9744::mapVolumeToBoundedRange(const uint8_t volume, uint8_t *volume_map, 
                                         const size_t volume_map_size) {
-    if (volume_map_size != (size_t)DB_FAST_COEFFICIENT_COUNT) {
+    if ((volume_map_size != (size_t)DB_FAST_COEFFICIENT_COUNT) || 
+        (volume > MAX9744_MAXIMUM_VOL_LEVEL)) {
       return; // volumeMap array isn't sized right so return without doing anything
     }
-    uint8_t a = MAX9744_MINIMUM_VOL_LEVEL;
-    uint8_t b = MAX9744_MAXIMUM_VOL_LEVEL;
-    int16_t gain_current_volume = this->getGainAtVolumeIndex(volume);
 
     // reset the volume map index used by getVolumeMapIndx() to the default mid value
     vm_index_previous = (DB_FAST_COEFFICIENT_COUNT >> 1);
 
-    // find the upper and lower bounds for volume values
-    if (volume != 0) {
-      for(int16_t k = volume - 1; k >= 0; k--) {
-        if ((this->getGainAtVolumeIndex(k) - gain_current_volume) < MILLIBEL_BOUND_LOWER) {
-          a = k + 1;
-          break;
-        }
+#if MAX9744_PRECOMPUTE_VOLUME_MAPS
+    // copy the precomputed map for this volume out of PROGMEM
+    memcpy_P(volume_map, volume_maps[volume], DB_FAST_COEFFICIENT_COUNT);
+#else
+    int16_t gain_current_volume = this->getGainAtVolumeIndex(volume);
+
+    // find the lowest volume within MILLIBEL_BOUND_LOWER of the current gain, the gain
+    // table is monotonic so binary search for the first index that is not below the bound
+    uint8_t a = MAX9744_MINIMUM_VOL_LEVEL;
+    uint8_t span = volume;
+    while (span > 0) {
+      uint8_t half = span >> 1;
+      if ((this->getGainAtVolumeIndex(a + half) - gain_current_volume) < MILLIBEL_BOUND_LOWER) {
+        a = a + half + 1;
+        span = span - half - 1;
       }
-    }
-    if (volume != MAX9744_MAXIMUM_VOL_LEVEL) {
-      for(uint8_t k = volume + 1; k < MAX9744_MAXIMUM_VOL_LEVEL; k++) {
-        if ((this->getGainAtVolumeIndex(k) - gain_current_volume) > MILLIBEL_BOUND_UPPER) {
-          b = k - 1;
-          break;
-        }
+      else {
+        span = half;
       }
     }
 
-    uint8_t v_range = (b - a) + 1;
-    uint8_t v[v_range];
-    for (int16_t k = b; k >= (int16_t)a; k--) {
-      v[b - k] = k;
-    }
-
-    int16_t c_normal[v_range];
-    //int16_t c_offset[v_range] = {0};
-    for (uint8_t k = 0; k < v_range; k++) {
-      c_normal[k] = this->getGainAtVolumeIndex(v[k]) - gain_current_volume;
+    // find the first volume above MILLIBEL_BOUND_UPPER (searching up to but not including
+    // the maximum level), the highest volume within the bound is the one below it
+    uint8_t b = volume + 1;
+    span = (volume < MAX9744_MAXIMUM_VOL_LEVEL) ? (MAX9744_MAXIMUM_VOL_LEVEL - b) : 0;
+    while (span > 0) {
+      uint8_t half = span >> 1;
+      if ((this->getGainAtVolumeIndex(b + half) - gain_current_volume) <= MILLIBEL_BOUND_UPPER) {
+        b = b + half + 1;
+        span = span - half - 1;
+      }
+      else {
+        span = half;
+      }
     }
+    b = (b >= MAX9744_MAXIMUM_VOL_LEVEL) ? MAX9744_MAXIMUM_VOL_LEVEL : (b - 1);
 
+    // map entries count down from `b`, skipping the entry at the current volume
+    uint8_t v_range = (b - a) + 1;
     uint8_t skip_zero_index = 0;
     uint8_t map_index = 0;
     for (uint8_t k = 0; k < volume_map_size; k++) {
-      if (c_normal[map_index] == 0) {
+      if ((b - map_index) == volume) {
         skip_zero_index = 1;
       }
       if ((map_index + skip_zero_index) < v_range) {
-        if ((MILLIBEL_BOUND_UPPER - c_normal[map_index + skip_zero_index]) 
-            < (k * MILLIBEL_STEP_SIZE)) {
+        int16_t c_normal = this->getGainAtVolumeIndex(b - (map_index + skip_zero_index)) 
+                           - gain_current_volume;
+        if ((MILLIBEL_BOUND_UPPER - c_normal) < (int16_t)(k * MILLIBEL_STEP_SIZE)) {
           map_index++;
         }
       }
-      volume_map[k] = v[map_index];
+      volume_map[k] = b - map_index;
     }
+#endif
   }
 
   // return a hysterisis-filtered volume map index value that corresponds to the mean audio level
@@ -223,23 +482,84 @@ namespace MAX9744 {
     if (dB_levels_size != (size_t)(DB_FAST_COEFFICIENT_COUNT << 1)) {
       return (uint8_t)(DB_FAST_COEFFICIENT_COUNT >> 1);
     }
-    for (int8_t k = (DB_FAST_COEFFICIENT_COUNT - 1); k >= 0; k--) {
-      if ((dB_levels[k] <= audio_level) | (k < 1)) {
-        if (abs(vm_index_previous - k) > 1) {
-          vm_index_previous = ((vm_index_previous < k) ? 
-                              (vm_index_previous + 1) : 
-                              (vm_index_previous - 1));
+    int8_t k = (DB_FAST_COEFFICIENT_COUNT - 1);
+    while ((k > 0) && (dB_levels[k] > audio_level)) {
+      k--;
+    }
+    return this->updateVolumeMapIndx(k);
+  }
+
+  // return the volume map index of an audio level, using the log2 level estimator
+  uint8_t MAX9744::getVolumeMapIndx(const uint16_t audio_level) {
+    if (base_level < LOG2_MINIMUM_BASE_LEVEL) {
+      // binary search for the highest threshold at or below the level, building each
+      // threshold the same way as dBFastRelativeLevel()
+      int8_t a = 0;
+      int8_t b = DB_FAST_COEFFICIENT_COUNT - 1;
+      while (a < b) {
+        int8_t half = (a + b + 1) >> 1;
+        uint16_t threshold = ((uint32_t)base_level * pgm_read_word(&(dB_fast_coefficient[half]))) >> 12;
+        if (threshold <= audio_level) {
+          a = half;
         }
-        else if (((vm_index_previous < 2) & (k < vm_index_previous)) |
-                ((vm_index_previous > 22) & (k > vm_index_previous))){
-          vm_index_previous = k;
+        else {
+          b = half - 1;
         }
-        break;
       }
+      return this->updateVolumeMapIndx(a);
+    }
+
+    // offset so index 0 is at MILLIBEL_BOUND_LOWER, then divide by MILLIBEL_STEP_SIZE
+    int16_t relative = this->levelToMilliBels(audio_level) - base_milliBels - MILLIBEL_BOUND_LOWER;
+    int8_t k = 0;
+    if (relative > 0) {
+      uint16_t steps = ((uint32_t)relative * MILLIBEL_STEP_RECIPROCAL) >> 16;
+      k = (steps >= DB_FAST_COEFFICIENT_COUNT) ? (DB_FAST_COEFFICIENT_COUNT - 1) : steps;
+    }
+    return this->updateVolumeMapIndx(k);
+  }
+
+  // move the volume map index by one step at a time, except at the ends of the map
+  uint8_t MAX9744::updateVolumeMapIndx(const int8_t k) {
+    if (abs(vm_index_previous - k) > 1) {
+      vm_index_previous = ((vm_index_previous < k) ? 
+                          (vm_index_previous + 1) : 
+                          (vm_index_previous - 1));
+    }
+    else if (((vm_index_previous < 2) & (k < vm_index_previous)) |
+            ((vm_index_previous > (DB_FAST_COEFFICIENT_COUNT - 3)) & (k > vm_index_previous))) {
+      vm_index_previous = k;
     }
     return vm_index_previous;
   }
 
+  // estimate an audio level in milliBels from a fixed-point log2
+  int16_t MAX9744::levelToMilliBels(const uint16_t level) {
+    if (level < 2) {
+      return 0;
+    }
+
+    // integer part of log2 is the position of the leading one
+    uint8_t msb = (uint8_t)((sizeof(unsigned int) * 8 - 1) - __builtin_clz((unsigned int)level));
+
+    // normalise so the leading one is bit 15, the next 4 bits pick the segment
+    // and the remaining 11 bits interpolate within it
+    uint16_t normal = level << (15 - msb);
+    uint8_t segment = (normal >> 11) & (LOG2_FRACTION_SEGMENTS - 1);
+    uint16_t remainder = normal & 0x07FF;
+    uint16_t lower = pgm_read_word(&(log2_fraction[segment]));
+    uint16_t upper = pgm_read_word(&(log2_fraction[segment + 1]));
+    uint16_t log2_q8 = ((uint16_t)msb << 8) + lower + (((upper - lower) * (uint32_t)remainder) >> 11);
+
+    return (int16_t)(((uint32_t)log2_q8 * MILLIBELS_PER_LOG2_Q13) >> 13);
+  }
+
+  // set the base level of the volume map, in milliBels
+  void MAX9744::setRelativeBaseLevel(const uint16_t base_level) {
+    this->base_level = base_level;
+    base_milliBels = this->levelToMilliBels(base_level);
+  }
+
   // update the relative dB level bands using currently defined volume level
   void MAX9744::dBFastRelativeLevel(uint16_t *dB_levels, const uint16_t base_level) {
     for(uint8_t k = 0; k < DB_FAST_COEFFICIENT_COUNT; k++) {
@@ -38,6 +38,38 @@
   #define MILLIBEL_BOUND_UPPER ((int16_t)600)
   #define MILLIBEL_STEP_SIZE   ((int16_t)50)
 
+  // fixed-point log2 level estimator, log2 is Q8.8 and interpolated over 16 segments
+  #define LOG2_FRACTION_SEGMENTS     ( 16U)
+  // milliBels per log2 unit (20 * log10(2) * 100 = 602.06) as Q.13, and 1 / MILLIBEL_STEP_SIZE as Q.16
+  #define MILLIBELS_PER_LOG2_Q13     (19266UL)
+  #define MILLIBEL_STEP_RECIPROCAL   ( 1311UL)
+  // below this base level the legacy integer thresholds are too coarse for the estimator to
+  // stay within one index of them, so getVolumeMapIndx(audio_level) searches them instead
+  #define LOG2_MINIMUM_BASE_LEVEL    ( 64U)
+
+  // store the volume map of every volume setting in PROGMEM (1600 bytes of flash), so
+  // mapVolumeToBoundedRange() is a single table copy instead of a search of the gain table,
+  // define as false (e.g. with a build flag) to search the gain table and save the flash
+  #ifndef MAX9744_PRECOMPUTE_VOLUME_MAPS
+    #define MAX9744_PRECOMPUTE_VOLUME_MAPS (true)
+  #endif
+
+  // volume shadow value used before the first volume write, when the device state is unknown
+  #define MAX9744_VOLUME_UNKNOWN     (0xFFU)
+
+  // bytes on the bus for a single volume write (address byte plus volume byte)
+  #define MAX9744_VOLUME_WRITE_BYTES (2U)
+
+  // gain reported by getGainMilliBels() before the first volume write
+  #define MAX9744_GAIN_UNKNOWN       ((int16_t)INT16_MIN)
+
+  // the group mute can set every MUTE pin with a single port write on AVR targets
+  #if defined(__AVR__)
+    #define MAX9744_GROUP_PORT_MUTE (true )
+  #else
+    #define MAX9744_GROUP_PORT_MUTE (false)
+  #endif
+
   namespace MAX9744{
     namespace MAX9744Types {
       /*! @enum TwoWire error types */
@@ -49,6 +81,20 @@
         OTHER, 
         TIME_OUT
       };
+
+      /*! @enum Rounding direction used when a gain falls between two volume settings */
+      enum gain_rounding_t {
+        ROUND_NEAREST = 0,
+        ROUND_DOWN,       // the nearest volume setting with a gain at or below the request
+        ROUND_UP          // the nearest volume setting with a gain at or above the request
+      };
+
+      /*! @struct Volume write statistics, see `MAX9744::getVolumeStats()` */
+      struct volume_stats_t {
+        uint32_t writes;            // volume writes sent to the device
+        uint32_t writes_skipped;    // redundant volume writes skipped via the volume shadow
+        uint32_t bus_bytes_saved;   // bus bytes not sent because of skipped writes
+      };
     }
 
     class MAX9744 {
@@ -141,13 +187,43 @@
         */
         inline int16_t getGainAtVolumeIndex(uint8_t index);
 
-        /*! @brief  Initialize the MAX9744
+        /*! @brief  Set the amplifier gain in milliBels (1/100 dB)
         *
-        * @details Initialize the device and write default config values to all registers
+        * @details The gain is matched to a volume setting with `getVolumeAtGain()` and
+        *          written with `volume()`, so redundant writes are skipped
         * 
-        * @param i2c_address The physical device's I2C address
-        * @param reset_n     The microcontroller pin connected to the device RESET_L next
-        * @param pWire       A pointer to an instance of the TwoWire class 
+        * @param milliBels The requested gain, e.g. -2000 for -20 dB
+        * @param rounding  How to pick between the two volume settings around the gain
+        */
+        void setGainMilliBels(int16_t milliBels, 
+                              MAX9744Types::gain_rounding_t rounding = MAX9744Types::ROUND_NEAREST);
+
+        /*! @brief  The gain of the volume setting most recently written to the device
+        *
+        * @returns int16_t  The gain in milliBels, or MAX9744_GAIN_UNKNOWN before the first write
+        */
+        int16_t getGainMilliBels(void);
+
+        /*! @brief  Find the volume setting for a gain with a binary search of the gain table
+        *
+        * @details Gains outside the amplifier range are clamped to the lowest/highest setting
+        * 
+        * @param milliBels The requested gain in milliBels (1/100 dB)
+        * @param rounding  How to pick between the two volume settings around the gain
+        * @returns uint8_t The volume setting (0-63)
+        */
+        uint8_t getVolumeAtGain(int16_t milliBels, 
+                                MAX9744Types::gain_rounding_t rounding = MAX9744Types::ROUND_NEAREST);
+
+        /*! @brief  Copy the gains of a range of volume settings, in milliBels
+        *
+        * @details The range is inclusive and copied in a single pass from PROGMEM, nothing
+        *          is written if `values` is too small or the range is out of bounds
+        * 
+        * @param start  The first volume setting of the range (0-63)
+        * @param stop   The last volume setting of the range (0-63)
+        * @param values The array to fill, `values[0]` is the gain of the lower setting
+        * @param size   The number of elements in `values`
         */
         void convertVolumeToGain(const uint8_t start, 
                                  const uint8_t stop, 
@@ -188,20 +264,93 @@
         */
         void dBFastRelativeLevel(uint16_t *dB_levels, const uint16_t base_level);
 
-        /*! @brief  Initialize the MAX9744
+        /*! @brief  Estimate an audio level in milliBels (1/100 dB) relative to a level of 1
         *
-        * @details Initialize the device and write default config values to all registers
+        * @details A fixed-point log2 from the position of the leading one bit plus a
+        *          16-segment interpolation table, accurate to within 5 milliBels
         * 
-        * @param i2c_address The physical device's I2C address
-        * @param reset_n     The microcontroller pin connected to the device RESET_L next
-        * @param pWire       A pointer to an instance of the TwoWire class 
+        * @param level     The audio level, a level of 0 is treated as 1
+        * @returns int16_t The level in milliBels (0 to 9632)
+        */
+        int16_t levelToMilliBels(const uint16_t level);
+
+        /*! @brief  Set the audio level mapped to the middle of the volume map
+        *
+        * @details Replaces the threshold array built by `dBFastRelativeLevel()`, the
+        *          level and its value in milliBels are stored for `getVolumeMapIndx(audio_level)`
+        * 
+        * @param base_level The audio level at the present volume setting
+        */
+        void setRelativeBaseLevel(const uint16_t base_level);
+
+        /*! @brief  Get the volume map index for an audio level relative to the base level
+        *
+        * @details Same as `getVolumeMapIndx(audio_level, dB_levels, dB_levels_size)`, but the
+        *          index is computed from `levelToMilliBels()` instead of scanning thresholds,
+        *          and agrees with it to within one index. Below a base level of
+        *          LOG2_MINIMUM_BASE_LEVEL the thresholds are binary searched instead, which
+        *          gives the same index as the scan.
+        * 
+        * @param audio_level The latest audio level
+        * @returns uint8_t   The volume map index (0-24)
+        */
+        uint8_t getVolumeMapIndx(const uint16_t audio_level);
+
+        /*! @brief  Update a 32-element decaying level buffer and return its mean
+        *
+        * @details Re-sums the whole buffer on every call, prefer `DecayBuffer::DecayBuffer`
+        *          (decaybuffer.h), which owns its storage and keeps an O(1) running sum
+        * 
+        * @param data_buffer               A 32-element buffer of decaying audio levels
+        * @param buffer_size               The size of the buffer as returned by sizeof()
+        * @param data_mean                 The latest audio level
+        * @param nominal_zero_signal_level The audio level measured with no signal present
         */
         uint16_t decayBuffer32(uint16_t *data_buffer, 
                                const size_t buffer_size, 
                                uint16_t const data_mean, 
                                const uint16_t nominal_zero_signal_level);
 
+        /*! @brief  Start a non-blocking volume ramp
+        *
+        * @details The volume moves towards `target` as `tick()` is called, by as many
+        *          volume steps as the slew rate allows since the last write, coalesced
+        *          into a single write per tick. A slew rate of zero jumps on the next tick.
+        * 
+        * @param target         The volume setting to ramp to (0-63)
+        * @param slew_milliBels The maximum rate of gain change, in milliBels (1/100 dB) per second
+        */
+        void ramp(uint8_t target, uint16_t slew_milliBels);
+
+        /*! @brief  Advance the volume ramp started by `ramp()`, call this from the main loop
+        *
+        * @returns bool  'True' if a volume write was issued
+        */
+        bool tick(void);
+
+        /*! @brief  Check if a volume ramp is still in progress */
+        bool ramping(void);
+
+        /*! @brief  The volume setting most recently acknowledged by the device
+        *
+        * @returns uint8_t  The volume (0-63), or MAX9744_VOLUME_UNKNOWN before the first write
+        *                   and after a failed write
+        */
+        uint8_t getVolume(void);
+
+        /*! @brief  Volume write statistics, including bus bytes saved by skipping redundant writes */
+        MAX9744Types::volume_stats_t getVolumeStats(void);
+
+        /*! @brief  The microcontroller pin connected to the device MUTE input */
+        uint8_t getMutePin(void) { return mute_p; }
+
+        /*! @brief  'True' if the MUTE pin is driven LOW to mute, see `invertMuteLogic()` */
+        bool    getMuteInverted(void) { return invert_mute; }
+
       private:
+        // move `vm_index_previous` towards a new volume map index with hysteresis
+        uint8_t updateVolumeMapIndx(const int8_t index);
+
         const uint8_t i2c_address;
         const uint8_t mute_p;
         const uint8_t shutdown_n;
@@ -213,8 +362,191 @@
         // index for keeping track of the most recent Volume Map index
         uint8_t vm_index_previous;
 
+        // base level for getVolumeMapIndx(audio_level), and the same level in milliBels
+        uint16_t base_level;
+        int16_t  base_milliBels;
+
+        // shadow of the most recently written volume, and volume write statistics
+        uint8_t volume_level;
+        MAX9744Types::volume_stats_t volume_stats;
+
+        // volume ramp target, slew rate (milliBels per second), and time of the last ramp step
+        uint8_t  ramp_target;
+        uint16_t ramp_slew;
+        uint32_t ramp_timestamp;
+
         TwoWire *pWire;
     };
+
+    /*! @brief Volume control for several MAX9744 zones sharing one TwoWire bus
+    *
+    * @details Each zone's volume is the master volume plus a per-zone offset, clamped to
+    *          the amplifier range. Setting the master volume or an offset only records it,
+    *          `update()` then writes just the zones whose effective volume changed. When
+    *          every MUTE pin is on the same port, `mute()` and `unmute()` set them all with
+    *          a single port write so the zones mute together.
+    */
+    template <uint8_t zones>
+    class MAX9744Group {
+      static_assert(zones >= 1, "MAX9744Group needs at least one zone");
+
+      public:
+        /*! @brief Class constructor
+        *
+        * @param amplifiers An array of pointers to the MAX9744 of each zone
+        */
+        MAX9744Group(MAX9744 *const (&amplifiers)[zones]);
+
+        /*! @brief  Initialize every zone amplifier, see `MAX9744::init()`
+        *
+        * @returns bool  'True' if every amplifier acknowledged its address
+        */
+        bool     init(void);
+
+        /*! @brief  Set the master volume applied to every zone (0-63) */
+        void     setMasterVolume(const uint8_t volume);
+
+        /*! @brief  Set the volume offset of one zone, in volume steps relative to the master */
+        void     setOffset(const uint8_t zone, const int8_t offset);
+
+        /*! @brief  The volume setting of a zone, master volume plus offset, clamped to 0-63 */
+        uint8_t  getZoneVolume(const uint8_t zone);
+
+        /*! @brief  Write the volume of every zone whose effective volume changed
+        *
+        * @returns uint8_t  The number of zones written
+        */
+        uint8_t  update(void);
+
+        /*! @brief  Mute every zone, in a single port write when the MUTE pins share a port */
+        void     mute(void);
+
+        /*! @brief  Unmute every zone, in a single port write when the MUTE pins share a port */
+        void     unmute(void);
+
+      private:
+        MAX9744 *amplifiers[zones];
+        int8_t  offsets[zones];
+        uint8_t master_volume;
+
+        void     setMuteSignal(const bool muted);
+    };
+
+    // class constructor for MAX9744Group object
+    template <uint8_t zones>
+    MAX9744Group<zones>::MAX9744Group(MAX9744 *const (&amplifiers)[zones]) :
+      offsets{0},
+      master_volume(MAX9744_MINIMUM_VOL_LEVEL) {
+      for (uint8_t k = 0; k < zones; k++) {
+        this->amplifiers[k] = amplifiers[k];
+      }
+    }
+
+    // initialize every zone amplifier, all zones are left muted
+    template <uint8_t zones>
+    bool MAX9744Group<zones>::init(void) {
+      bool acknowledged = true;
+      for (uint8_t k = 0; k < zones; k++) {
+        acknowledged = amplifiers[k]->init() && acknowledged;
+      }
+      return acknowledged;
+    }
+
+    // set the master volume, the zones are written on the next update()
+    template <uint8_t zones>
+    void MAX9744Group<zones>::setMasterVolume(const uint8_t volume) {
+      master_volume = (volume > MAX9744_MAXIMUM_VOL_LEVEL) ? MAX9744_MAXIMUM_VOL_LEVEL : volume;
+    }
+
+    // set the offset of one zone, the zone is written on the next update()
+    template <uint8_t zones>
+    void MAX9744Group<zones>::setOffset(const uint8_t zone, const int8_t offset) {
+      if (zone < zones) {
+        offsets[zone] = offset;
+      }
+    }
+
+    // return the master volume plus the zone offset, clamped to the amplifier range
+    template <uint8_t zones>
+    uint8_t MAX9744Group<zones>::getZoneVolume(const uint8_t zone) {
+      if (zone >= zones) {
+        return MAX9744_MINIMUM_VOL_LEVEL;
+      }
+      int16_t volume = (int16_t)master_volume + offsets[zone];
+      if (volume < (int16_t)MAX9744_MINIMUM_VOL_LEVEL) {
+        return MAX9744_MINIMUM_VOL_LEVEL;
+      }
+      if (volume > (int16_t)MAX9744_MAXIMUM_VOL_LEVEL) {
+        return MAX9744_MAXIMUM_VOL_LEVEL;
+      }
+      return (uint8_t)volume;
+    }
+
+    // write only the zones whose effective volume differs from their last written volume
+    template <uint8_t zones>
+    uint8_t MAX9744Group<zones>::update(void) {
+      uint8_t written = 0;
+      for (uint8_t k = 0; k < zones; k++) {
+        uint8_t volume = this->getZoneVolume(k);
+        if (volume != amplifiers[k]->getVolume()) {
+          amplifiers[k]->volume(volume);
+          written++;
+        }
+      }
+      return written;
+    }
+
+    // mute every zone amplifier
+    template <uint8_t zones>
+    void MAX9744Group<zones>::mute(void) {
+      this->setMuteSignal(true);
+    }
+
+    // unmute every zone amplifier
+    template <uint8_t zones>
+    void MAX9744Group<zones>::unmute(void) {
+      this->setMuteSignal(false);
+    }
+
+    // drive every MUTE pin, with one port write if they share a port, otherwise pin by pin
+    template <uint8_t zones>
+    void MAX9744Group<zones>::setMuteSignal(const bool muted) {
+#if MAX9744_GROUP_PORT_MUTE
+      uint8_t port = digitalPinToPort(amplifiers[0]->getMutePin());
+      uint8_t mask_high = 0;
+      uint8_t mask_low = 0;
+      bool shared_port = (port != NOT_A_PIN);
+      for (uint8_t k = 0; (k < zones) && shared_port; k++) {
+        uint8_t pin = amplifiers[k]->getMutePin();
+        shared_port = (digitalPinToPort(pin) == port);
+
+        // a non-inverted MUTE pin is driven HIGH to mute, an inverted one LOW
+        if (amplifiers[k]->getMuteInverted() == muted) {
+          mask_low |= digitalPinToBitMask(pin);
+        }
+        else {
+          mask_high |= digitalPinToBitMask(pin);
+        }
+      }
+
+      if (shared_port) {
+        volatile uint8_t *output = portOutputRegister(port);
+        uint8_t sreg = SREG;
+        cli();
+        *output = (*output | mask_high) & (uint8_t)~mask_low;
+        SREG = sreg;
+        return;
+      }
+#endif
+      for (uint8_t k = 0; k < zones; k++) {
+        if (muted) {
+          amplifiers[k]->mute();
+        }
+        else {
+          amplifiers[k]->unmute();
+        }
+      }
+    }
   }
 
 #endif
@@ -19,12 +19,57 @@
 #include "MSGEQ7.h"
 
 namespace MSGEQ7 {
+  using namespace MSGEQ7Types;
+
+  // integer square root of a 32-bit value, one result bit per iteration
+  uint16_t isqrt32(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) {
+      bit >>= 2;
+    }
+    while (bit != 0) {
+      if (value >= (root + bit)) {
+        value -= root + bit;
+        root = (root >> 1) + bit;
+      }
+      else {
+        root >>= 1;
+      }
+      bit >>= 2;
+    }
+    return (uint16_t)root;
+  }
+
   // class constructor for MSGEQ7 object
   MSGEQ7::MSGEQ7(uint8_t strobe_p, uint8_t dc_out, uint8_t reset_p, bool use_input_pullup) :
     strobe_p(strobe_p), 
     dc_out(dc_out), 
     reset_p(reset_p), 
-    use_input_pullup(use_input_pullup) { }
+    use_input_pullup(use_input_pullup),
+    adc_mode(ADC_BLOCKING),
+    weights(&Weighting::ISO226_60Phon),
+    adc_channel(0),
+    adc_pending(false),
+    sample_state(IDLE),
+    sample_band(0),
+    sample_timestamp(0),
+    frame{0U} { }
+
+  MSGEQ7::MSGEQ7(uint8_t strobe_p, uint8_t dc_out, uint8_t reset_p, bool use_input_pullup, 
+                 adc_mode_t adc_mode) :
+    strobe_p(strobe_p), 
+    dc_out(dc_out), 
+    reset_p(reset_p), 
+    use_input_pullup(use_input_pullup),
+    adc_mode(((adc_mode == ADC_ASYNC) && !MSGEQ7_ASYNC_ADC_SUPPORTED) ? ADC_BLOCKING : adc_mode),
+    weights(&Weighting::ISO226_60Phon),
+    adc_channel(0),
+    adc_pending(false),
+    sample_state(IDLE),
+    sample_band(0),
+    sample_timestamp(0),
+    frame{0U} { }
 
   // initialize the MSGEQ7 reset and strobe signals
   void MSGEQ7::init(void) {
@@ -43,15 +88,22 @@ namespace MSGEQ7 {
       // initialize analog input 1 without internal pullup active
       digitalWrite(dc_out, INPUT);
     }
+
+    // allow for either analog channel or pin numbers, the same as analogRead()
+    adc_channel = (dc_out >= A0) ? (dc_out - A0) : dc_out;
+#if defined(analogPinToChannel)
+    adc_channel = analogPinToChannel(adc_channel);
+#endif
   }
 
   // find mean of the `array_values` data read from MSGEQ7
   uint16_t MSGEQ7::mean(uint16_t read_array[], const size_t array_size) {
-    uint16_t sum = 0;
+    // accumulate in 32 bits, seven pre-shifted bands can overflow a uint16_t
+    uint32_t sum = 0;
     if ((uint16_t)array_size != (uint16_t)14) {
       // there are 7 spectral bands so the array size must be 14 bytes
       // if this is not the case then don't do anything and return zero
-      return sum;
+      return (uint16_t)sum;
     }
     else {
       // calculate the sum of levelRead array
@@ -59,11 +111,11 @@ namespace MSGEQ7 {
         sum = sum + read_array[k];
       }
       // much faster than divide-by-7, accurate to 7.00
-      return (sum * 585L) >> 12;
+      return (uint16_t)((sum * 585UL) >> 12);
     }
   }
 
-  // read spectral band data from the MSGEQ7 and write to `read_array`
+  // read the newest spectral band frame from the MSGEQ7 and write to `read_array`
   void MSGEQ7::read(uint16_t read_array[], const size_t array_size) {
     if ((uint16_t)array_size != (uint16_t)14) {
       // there are 7 spectral bands so the array size must be 14 bytes
@@ -71,35 +123,420 @@ namespace MSGEQ7 {
       return;
     }
     else {
-      // start by setting RESET pin low to enable output
-      digitalWrite(reset_p, LOW);
-      delayMicroseconds(100);
+      // discard queued frames, they may be from long before this call
+      MSGEQ7Types::frame_t stale;
+      frames.popNewest(stale);
 
-      // pulse STROBE pin to read all 7 frequency bands
-      for(uint8_t k = 0; k < 7; k++) {
-        // set STROBE pin low to enable output
-        digitalWrite(strobe_p, LOW);
-        delayMicroseconds(65);
+      // a sequence already under way sampled some bands before this call, so let it
+      // finish and discard it too
+      if (sample_state != IDLE) {
+        while (!this->update()) { }
+        frames.popNewest(stale);
+      }
+
+      // drive the sampling sequence until a fresh frame is available
+      while (!this->update()) { }
+      this->getFrame(read_array, array_size);
+    }
+  }
+
+  // step through the reset/strobe sequence without blocking, one band per strobe window
+  bool MSGEQ7::update(void) {
+    uint32_t now = micros();
+
+    switch (sample_state) {
+      case IDLE: {
+        // start by setting RESET pin low to enable output
+        digitalWrite(reset_p, LOW);
+        sample_band = 0;
+        sample_timestamp = now;
+        sample_state = RESET_RELEASE;
+      }
+      break;
+
+      case RESET_RELEASE: {
+        if ((now - sample_timestamp) >= MSGEQ7_RESET_DELAY_MICROS) {
+          // set STROBE pin low to enable output of the first band
+          digitalWrite(strobe_p, LOW);
+          sample_timestamp = now;
+          sample_state = STROBE_LOW;
+        }
+      }
+      break;
+
+      case STROBE_LOW: {
+        if ((now - sample_timestamp) >= MSGEQ7_STROBE_SETTLE_MICROS) {
+          if (adc_mode == ADC_ASYNC) {
+            // collect the previous band's conversion before starting this band's
+            if (adc_pending) {
+              if (!this->adcComplete()) {
+                break;
+              }
+              frame[sample_band - 1] = weightBand(this->adcResult() << 3, sample_band - 1, weights);
+            }
+            this->adcStart();
+            sample_timestamp = now;
+            sample_state = SAMPLE_HOLD;
+            break;
+          }
+
+          // read signal band level, and apply the loudness weighting
+          uint16_t level = (adc_mode == ADC_OVERSAMPLED) ? this->oversample() : analogRead(dc_out);
+          frame[sample_band] = weightBand(level << 3, sample_band, weights);
+
+          // set STROBE pin high again to prepare for next band reading
+          digitalWrite(strobe_p, HIGH);
+          sample_timestamp = micros();
+          sample_state = STROBE_HIGH;
+        }
+      }
+      break;
+
+      case SAMPLE_HOLD: {
+        if ((now - sample_timestamp) >= MSGEQ7_ADC_HOLD_MICROS) {
+          // DC_OUT has been sampled, so set STROBE pin high while the conversion completes
+          digitalWrite(strobe_p, HIGH);
+          sample_timestamp = now;
+          sample_state = STROBE_HIGH;
+        }
+      }
+      break;
+
+      case STROBE_HIGH: {
+        if ((now - sample_timestamp) >= MSGEQ7_STROBE_HOLD_MICROS) {
+          if (sample_band < (MSGEQ7_BAND_COUNT - 1)) {
+            // set STROBE pin low to enable output of the next band
+            sample_band++;
+            digitalWrite(strobe_p, LOW);
+            sample_timestamp = now;
+            sample_state = STROBE_LOW;
+          }
+          else {
+            if (adc_pending) {
+              // collect the last band's conversion before completing the frame
+              if (!this->adcComplete()) {
+                break;
+              }
+              frame[sample_band] = weightBand(this->adcResult() << 3, sample_band, weights);
+            }
+
+            // set RESET high again to reset MSGEQ7 multiplexer
+            digitalWrite(reset_p, HIGH);
+            frames.push(frame);
+            sample_state = IDLE;
+          }
+        }
+      }
+      break;
+    }
+
+    return (frames.available() != 0);
+  }
+
+  // check if update() has completed a frame that has not yet been collected
+  bool MSGEQ7::available(void) {
+    return (frames.available() != 0);
+  }
+
+  // copy the newest completed frame to `read_array`, discarding any older frames
+  bool MSGEQ7::getFrame(uint16_t read_array[], const size_t array_size) {
+    if ((uint16_t)array_size != (uint16_t)14) {
+      // there are 7 spectral bands so the array size must be 14 bytes
+      // if this is not the case then don't do anything
+      return false;
+    }
+    MSGEQ7Types::frame_t newest;
+    if (!frames.popNewest(newest)) {
+      return false;
+    }
+    memcpy(read_array, newest.band, array_size);
+    return true;
+  }
+
+  // copy the newest completed frame and its sequence number to `latest`
+  bool MSGEQ7::getFrame(frame_t &latest) {
+    return frames.popNewest(latest);
+  }
+
+  // number of completed frames the consumer never received
+  uint16_t MSGEQ7::lostFrames(void) {
+    return frames.lost();
+  }
+
+  // set the per-band loudness weighting table, or nullptr for no weighting
+  void MSGEQ7::setWeighting(const band_weights_t *weights) {
+    this->weights = weights;
+  }
+
+  // take several samples of DC_OUT and reduce them to one level using shifts only
+  uint16_t MSGEQ7::oversample(void) {
+#if MSGEQ7_OVERSAMPLE_MEDIAN
+    static_assert(MSGEQ7_OVERSAMPLE_LOG2 <= 3, "MSGEQ7 median oversampling is limited to 8 samples");
+
+    // insertion sort the samples as they are read
+    uint16_t samples[MSGEQ7_OVERSAMPLE_COUNT];
+    for (uint8_t n = 0; n < MSGEQ7_OVERSAMPLE_COUNT; n++) {
+      uint16_t sample = analogRead(dc_out);
+      uint8_t k = n;
+      while ((k > 0) && (samples[k - 1] > sample)) {
+        samples[k] = samples[k - 1];
+        k--;
+      }
+      samples[k] = sample;
+    }
+
+    // median of an even number of samples is the mean of the middle two
+    return (samples[(MSGEQ7_OVERSAMPLE_COUNT - 1) >> 1] + 
+            samples[MSGEQ7_OVERSAMPLE_COUNT >> 1]) >> 1;
+#else
+    static_assert(MSGEQ7_OVERSAMPLE_LOG2 <= 6, "MSGEQ7 oversampling is limited to 64 samples");
+
+    // 64 samples of a 10-bit ADC still fit in a uint16_t sum
+    uint16_t sum = 0;
+    for (uint8_t n = 0; n < MSGEQ7_OVERSAMPLE_COUNT; n++) {
+      sum += analogRead(dc_out);
+    }
+    return sum >> MSGEQ7_OVERSAMPLE_LOG2;
+#endif
+  }
+
+#if MSGEQ7_ASYNC_ADC_SUPPORTED
+  // select the DC_OUT channel and start a conversion without waiting for the result
+  void MSGEQ7::adcStart(void) {
+    ADMUX = (DEFAULT << 6) | (adc_channel & 0x07);
+  #if defined(MUX5)
+    ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((adc_channel >> 3) & 0x01) << MUX5);
+  #endif
+    ADCSRA |= (1 << ADSC);
+    adc_pending = true;
+  }
+
+  // check if the conversion started by adcStart() has completed
+  bool MSGEQ7::adcComplete(void) {
+    return !(ADCSRA & (1 << ADSC));
+  }
+
+  // return the result of the completed conversion
+  uint16_t MSGEQ7::adcResult(void) {
+    adc_pending = false;
+    return ADC;
+  }
+#else
+  // asynchronous conversions need the classic AVR ADC registers, so these are never used without them
+  void MSGEQ7::adcStart(void) {
+    adc_pending = true;
+  }
+
+  bool MSGEQ7::adcComplete(void) {
+    return true;
+  }
+
+  uint16_t MSGEQ7::adcResult(void) {
+    adc_pending = false;
+    return analogRead(dc_out);
+  }
+#endif
+
+  /**************************************************************************/
+  // class constructor for Envelope object using the default time constants
+  Envelope::Envelope(void) :
+    attack_shift(MSGEQ7_ENVELOPE_ATTACK_SHIFT),
+    release_shift(MSGEQ7_ENVELOPE_RELEASE_SHIFT),
+    peak_hold_frames(MSGEQ7_PEAK_HOLD_FRAMES),
+    peak_falloff(MSGEQ7_PEAK_FALLOFF_PER_FRAME) {
+    this->reset();
+  }
+
+  Envelope::Envelope(uint8_t attack_shift, uint8_t release_shift, 
+                     uint8_t peak_hold_frames, uint16_t peak_falloff) :
+    attack_shift(attack_shift),
+    release_shift(release_shift),
+    peak_hold_frames(peak_hold_frames),
+    peak_falloff(peak_falloff) {
+    this->reset();
+  }
+
+  // set the envelope time constants and peak hold behaviour
+  void Envelope::configure(uint8_t attack_shift, uint8_t release_shift, 
+                           uint8_t peak_hold_frames, uint16_t peak_falloff) {
+    this->attack_shift = attack_shift;
+    this->release_shift = release_shift;
+    this->peak_hold_frames = peak_hold_frames;
+    this->peak_falloff = peak_falloff;
+  }
+
+  // clear the envelope and peak state of every band
+  void Envelope::reset(void) {
+    memset(envelope, 0, sizeof(envelope));
+    memset(peak_level, 0, sizeof(peak_level));
+    memset(peak_hold, 0, sizeof(peak_hold));
+  }
+
+  // update the envelope and peak of every band from a new frame
+  void Envelope::update(const uint16_t read_array[], const size_t array_size) {
+    if ((uint16_t)array_size != (uint16_t)14) {
+      // there are 7 spectral bands so the array size must be 14 bytes
+      // if this is not the case then don't do anything and just return
+      return;
+    }
+
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      // one-pole attack/release, move a fraction 1/2^shift of the way towards the input
+      uint32_t input = (uint32_t)read_array[k] << 16;
+      if (input > envelope[k]) {
+        envelope[k] += (input - envelope[k]) >> attack_shift;
+      }
+      else {
+        envelope[k] -= (envelope[k] - input) >> release_shift;
+      }
+
+      // hold each new peak, then let it fall off linearly
+      if (read_array[k] >= peak_level[k]) {
+        peak_level[k] = read_array[k];
+        peak_hold[k] = peak_hold_frames;
+      }
+      else if (peak_hold[k] > 0) {
+        peak_hold[k]--;
+      }
+      else {
+        peak_level[k] = (peak_level[k] > peak_falloff) ? (peak_level[k] - peak_falloff) : 0;
+      }
+    }
+  }
+
+  // return the smoothed envelope level of a band
+  uint16_t Envelope::level(const uint8_t band) {
+    if (band >= MSGEQ7_BAND_COUNT) {
+      return 0;
+    }
+    return (uint16_t)(envelope[band] >> 16);
+  }
+
+  // return the held peak level of a band
+  uint16_t Envelope::peak(const uint8_t band) {
+    if (band >= MSGEQ7_BAND_COUNT) {
+      return 0;
+    }
+    return peak_level[band];
+  }
+
+  // copy the smoothed envelope level of every band to `read_array`
+  void Envelope::getLevels(uint16_t read_array[], const size_t array_size) {
+    if ((uint16_t)array_size != (uint16_t)14) {
+      return;
+    }
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      read_array[k] = (uint16_t)(envelope[k] >> 16);
+    }
+  }
 
-        // read signal band level, account for later loudness adj.
-        read_array[k] = analogRead(dc_out) << 3;
+  // copy the held peak level of every band to `read_array`
+  void Envelope::getPeaks(uint16_t read_array[], const size_t array_size) {
+    if ((uint16_t)array_size != (uint16_t)14) {
+      return;
+    }
+    memcpy(read_array, peak_level, array_size);
+  }
+
+  /**************************************************************************/
+  // class constructor for OnsetDetector object using the default threshold settings
+  OnsetDetector::OnsetDetector(void) :
+    sensitivity(MSGEQ7_ONSET_SENSITIVITY_Q4_4),
+    minimum_flux(MSGEQ7_ONSET_MINIMUM_FLUX),
+    refractory_millis(MSGEQ7_ONSET_REFRACTORY_MILLI) {
+    this->reset();
+  }
+
+  OnsetDetector::OnsetDetector(uint8_t sensitivity, uint16_t minimum_flux, 
+                               uint16_t refractory_millis) :
+    sensitivity(sensitivity),
+    minimum_flux(minimum_flux),
+    refractory_millis(refractory_millis) {
+    this->reset();
+  }
+
+  // set the adaptive threshold and refractory time
+  void OnsetDetector::configure(uint8_t sensitivity, uint16_t minimum_flux, 
+                                uint16_t refractory_millis) {
+    this->sensitivity = sensitivity;
+    this->minimum_flux = minimum_flux;
+    this->refractory_millis = refractory_millis;
+  }
+
+  // clear the flux history and previous frame
+  void OnsetDetector::reset(void) {
+    memset(previous, 0, sizeof(previous));
+    memset(flux_history, 0, sizeof(flux_history));
+    flux_sum = 0;
+    flux_index = 0;
+    flux_frames = 0;
+    flux_current = 0;
+    threshold_current = 0;
+    beat_count = 0;
+    last_beat.timestamp = 0;
+    last_beat.strength = 0;
+  }
 
-        // set STROBE pin high again to prepare for next band reading
-        digitalWrite(strobe_p, HIGH);
-        delayMicroseconds(35);
+  // update the detector with a new frame, return true if a beat was detected
+  bool OnsetDetector::update(const uint16_t read_array[], const size_t array_size, 
+                             const uint32_t timestamp) {
+    if ((uint16_t)array_size != (uint16_t)14) {
+      // there are 7 spectral bands so the array size must be 14 bytes
+      // if this is not the case then don't do anything and return false
+      return false;
+    }
+
+    // half-wave rectified spectral flux, only band level increases count towards an onset
+    uint32_t sum = 0;
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      if (read_array[k] > previous[k]) {
+        sum += read_array[k] - previous[k];
       }
+      previous[k] = read_array[k];
+    }
+    flux_current = (sum > 0xFFFFUL) ? (uint16_t)0xFFFF : (uint16_t)sum;
+
+    // adaptive threshold from the mean flux of the history window, before adding this frame
+    uint32_t limit = (((flux_sum / MSGEQ7_ONSET_HISTORY) * sensitivity) >> 4) + minimum_flux;
+    threshold_current = (limit > 0xFFFFUL) ? (uint16_t)0xFFFF : (uint16_t)limit;
 
-      // set RESET high again to reset MSGEQ7 multiplexer
-      digitalWrite(reset_p, HIGH);
+    flux_sum = flux_sum - flux_history[flux_index] + flux_current;
+    flux_history[flux_index] = flux_current;
+    flux_index = (flux_index + 1) & (MSGEQ7_ONSET_HISTORY - 1);
+
+    // don't report beats until the history (and the previous frame) is valid
+    if (flux_frames <= MSGEQ7_ONSET_HISTORY) {
+      flux_frames++;
+      return false;
+    }
 
-      // spectral band adj. (very) loosely based on ISO 226:2003 [60 phons]
-      read_array[0] = read_array[0] >> 3;   //   63 Hz
-      read_array[1] = read_array[1] >> 1;   //  160 Hz
-      read_array[2] = read_array[2] >> 0;   //  400 Hz
-      read_array[3] = read_array[3] << 0;   // 1000 Hz
-      read_array[4] = read_array[4] << 0;   // 2500 Hz
-      read_array[5] = read_array[5] >> 1;   // 6250 Hz
-      read_array[6] = read_array[6] >> 2;   //16000 Hz
+    if ((flux_current > threshold_current) && 
+        (((timestamp - last_beat.timestamp) >= refractory_millis) || (beat_count == 0))) {
+      last_beat.timestamp = timestamp;
+      last_beat.strength = flux_current - threshold_current;
+      beat_count++;
+      return true;
     }
+    return false;
+  }
+
+  // return the most recently detected beat
+  beat_event_t OnsetDetector::lastBeat(void) {
+    return last_beat;
+  }
+
+  // return the number of beats detected since the last reset
+  uint16_t OnsetDetector::beats(void) {
+    return beat_count;
+  }
+
+  // return the spectral flux of the most recent frame
+  uint16_t OnsetDetector::flux(void) {
+    return flux_current;
+  }
+
+  // return the threshold the most recent frame was compared against
+  uint16_t OnsetDetector::threshold(void) {
+    return threshold_current;
   }
 }
@@ -19,21 +19,815 @@
 #ifndef MSI_MSGEQ7_H
 #define MSI_MSGEQ7_H
 
+  #include <Arduino.h>
+  #include "../io/fastgpio.h"
+
+  // number of spectral bands output by the MSGEQ7
+  #define MSGEQ7_BAND_COUNT            ( 7U)
+
+  // MSGEQ7 reset and strobe timing (in microseconds)
+  #define MSGEQ7_RESET_DELAY_MICROS    (100U)
+  #define MSGEQ7_STROBE_SETTLE_MICROS  ( 65U)
+  #define MSGEQ7_STROBE_HOLD_MICROS    ( 35U)
+
+  // time for the AVR ADC sample-and-hold to capture DC_OUT after a conversion is started,
+  // 1.5 ADC clock cycles at the default 125 kHz ADC clock plus margin (in microseconds)
+  #define MSGEQ7_ADC_HOLD_MICROS       ( 16U)
+
+  // ADC_OVERSAMPLED mode takes 2^MSGEQ7_OVERSAMPLE_LOG2 samples per strobe window and either
+  // averages them or, if MSGEQ7_OVERSAMPLE_MEDIAN is true, takes their median (up to 8 samples)
+  #define MSGEQ7_OVERSAMPLE_LOG2       ( 2U)
+  #define MSGEQ7_OVERSAMPLE_MEDIAN     (false)
+  #define MSGEQ7_OVERSAMPLE_COUNT      (1U << MSGEQ7_OVERSAMPLE_LOG2)
+
+  // approximate duration of a single blocking analogRead() on a 16 MHz AVR (in microseconds)
+  #define MSGEQ7_ANALOGREAD_MICROS     (112U)
+
+  // asynchronous ADC conversions access the classic AVR ADC registers directly, so are only
+  // supported where they exist (not on the megaAVR 0-series or non-AVR targets)
+  #if defined(ADCSRA) && defined(ADMUX) && defined(ADSC) && defined(ADC)
+    #define MSGEQ7_ASYNC_ADC_SUPPORTED (true )
+  #else
+    #define MSGEQ7_ASYNC_ADC_SUPPORTED (false)
+  #endif
+
+  // number of frames buffered between update() and the frame consumer, must be a power of two
+  #define MSGEQ7_FRAME_RING_DEPTH      ( 4U)
+
+  // default envelope follower time constants, as shift counts (time constant ~ 2^shift frames)
+  #define MSGEQ7_ENVELOPE_ATTACK_SHIFT  ( 1U)
+  #define MSGEQ7_ENVELOPE_RELEASE_SHIFT ( 4U)
+
+  // default peak hold time (in frames) and peak fall-off per frame after the hold expires
+  #define MSGEQ7_PEAK_HOLD_FRAMES       (30U)
+  #define MSGEQ7_PEAK_FALLOFF_PER_FRAME (64U)
+
+  // onset detector flux history length (in frames, must be a power of two), default threshold
+  // multiplier over the mean flux in Q4.4, minimum flux for a beat, and minimum time between beats
+  #define MSGEQ7_ONSET_HISTORY          (16U)
+  #define MSGEQ7_ONSET_SENSITIVITY_Q4_4 (32U)
+  #define MSGEQ7_ONSET_MINIMUM_FLUX     (256U)
+  #define MSGEQ7_ONSET_REFRACTORY_MILLI (100U)
+
+  // prevent the compiler from reordering frame ring accesses across the index updates
+  #define MSGEQ7_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+
   namespace MSGEQ7 {
+    namespace MSGEQ7Types {
+      /*! @enum States of the non-blocking strobe/reset sequencer */
+      enum sample_state_t {
+        IDLE = 0,
+        RESET_RELEASE,
+        STROBE_LOW,
+        SAMPLE_HOLD,
+        STROBE_HIGH,
+      };
+
+      /*! @enum ADC conversion modes used for sampling DC_OUT */
+      enum adc_mode_t {
+        ADC_BLOCKING = 0,   // blocking analogRead() inside each strobe window
+        ADC_ASYNC,          // start conversion in the strobe window, collect it in the next
+        ADC_OVERSAMPLED,    // several blocking analogRead() per strobe window, mean or median
+      };
+
+      /*! @struct A single seven-band spectral frame and its sequence number */
+      struct frame_t {
+        uint16_t band[MSGEQ7_BAND_COUNT];
+        uint16_t sequence;
+      };
+
+      /*! @struct A detected beat, its time and its spectral flux over the threshold */
+      struct beat_event_t {
+        uint32_t timestamp;
+        uint16_t strength;
+      };
+
+      /*! @struct Per-band loudness weighting gains in Q8.8 fixed point (256 = unity) */
+      struct band_weights_t {
+        uint16_t gain[MSGEQ7_BAND_COUNT];
+      };
+    }
+
+    // convert a linear gain to Q8.8 fixed point at compile time
+    constexpr uint16_t gainToQ8_8(float gain) {
+      return (uint16_t)((gain * 256.0f) + 0.5f);
+    }
+
+    // 2^x for 0 <= x < 1, cubic approximation accurate to ~0.01%
+    constexpr float pow2Fraction(float x) {
+      return 1.0f + (x * (0.6958f + (x * (0.2251f + (x * 0.0791f)))));
+    }
+
+    // 2^x for any x, reduced to 0 <= x < 1 by recursion
+    constexpr float pow2(float x) {
+      return (x < 0.0f) ? (pow2(x + 1.0f) * 0.5f) : 
+             ((x >= 1.0f) ? (pow2(x - 1.0f) * 2.0f) : pow2Fraction(x));
+    }
+
+    // convert a gain in dB to Q8.8 fixed point at compile time, 10^(dB/20) = 2^(dB * log2(10)/20)
+    constexpr uint16_t dBToQ8_8(float dB) {
+      return gainToQ8_8(pow2(dB * 0.16609640f));
+    }
+
+    /*! @brief Band weighting tables, applied to band levels pre-shifted by `<< 3`
+    *
+    * @details Custom tables can be built at compile time from per-band dB offsets, e.g.
+    *          `constexpr band_weights_t curve = {{ dBToQ8_8(-18.0f), dBToQ8_8(-6.0f), ... }};`
+    */
+    namespace Weighting {
+      // spectral band adj. (very) loosely based on ISO 226:2003 [60 phons], the default
+      constexpr MSGEQ7Types::band_weights_t ISO226_60Phon = 
+      {{
+        gainToQ8_8(0.125f),   //   63 Hz
+        gainToQ8_8(0.500f),   //  160 Hz
+        gainToQ8_8(1.000f),   //  400 Hz
+        gainToQ8_8(1.000f),   // 1000 Hz
+        gainToQ8_8(1.000f),   // 2500 Hz
+        gainToQ8_8(0.500f),   // 6250 Hz
+        gainToQ8_8(0.250f)    //16000 Hz
+      }};
+    }
+
+    /*! @brief  Approximate frame acquisition time with 2^log2_samples ADC samples per band
+    *
+    * @details Use with `oversampledNoiseReduction()` to trade latency against noise floor,
+    *          e.g. 4 samples take ~3.9 ms per frame instead of ~1.5 ms for a single sample
+    */
+    constexpr uint32_t oversampledFrameMicros(uint8_t log2_samples) {
+      return MSGEQ7_RESET_DELAY_MICROS + (MSGEQ7_BAND_COUNT * (MSGEQ7_STROBE_SETTLE_MICROS + 
+             ((1UL << log2_samples) * MSGEQ7_ANALOGREAD_MICROS) + MSGEQ7_STROBE_HOLD_MICROS));
+    }
+
+    /*! @brief  Reduction of the uncorrelated noise floor from averaging 2^log2_samples samples
+    *
+    * @details 10 * log10(N) dB, i.e. ~3 dB per doubling, in milliBels (1/100 of a dB).
+    *          Medians reject impulsive noise better but reduce white noise slightly less.
+    */
+    constexpr uint16_t oversampledNoiseReduction(uint8_t log2_samples) {
+      return 301U * log2_samples;
+    }
+
+    /*! @brief  Apply a band weighting gain to a single band level
+    *
+    * @param    level     The band level, pre-shifted by `<< 3`
+    * @param    band      The band index (0-6)
+    * @param    weights   The weighting table, or nullptr for no weighting
+    * @returns  uint16_t  The weighted band level, saturated to 0xFFFF
+    */
+    inline uint16_t weightBand(const uint16_t level, const uint8_t band, 
+                               const MSGEQ7Types::band_weights_t *weights) {
+      if (weights == nullptr) {
+        return level;
+      }
+      uint32_t weighted = ((uint32_t)level * weights->gain[band]) >> 8;
+      return (weighted > 0xFFFFUL) ? (uint16_t)0xFFFF : (uint16_t)weighted;
+    }
+
+    /*! @brief Lock-free single-producer/single-consumer ring of spectral frames
+    *
+    * @details Frames are pushed by one producer (e.g. a timer interrupt calling
+    *          `MSGEQ7::update()`) and popped by one consumer (e.g. the main loop),
+    *          without disabling interrupts. The 8-bit head and tail indices are
+    *          each written by only one side, and a slot is never written while
+    *          it is between tail and head, so a popped frame is never torn.
+    *          Every produced frame is numbered, including frames dropped when the
+    *          ring is full, so the consumer can detect gaps via `lost()`.
+    */
+    template <uint8_t depth>
+    class FrameRing {
+      static_assert((depth >= 2) && (depth <= 128) && ((depth & (depth - 1)) == 0), 
+                    "FrameRing depth must be a power of two between 2 and 128");
+
+      public:
+        FrameRing(void) : head(0), tail(0), sequence(0), last_sequence(0), lost_count(0) { }
+
+        /*! @brief  Push a frame into the ring (producer side only)
+        *
+        * @param    bands   An array of seven band levels to copy into the ring
+        * @returns  bool    'True' if the frame was queued, 'False' if the ring was full
+        */
+        bool push(const uint16_t bands[]) {
+          uint8_t h = head;
+          sequence++;
+          if ((uint8_t)(h - tail) >= depth) {
+            // ring is full, drop the frame (the consumer will see the sequence gap)
+            return false;
+          }
+          MSGEQ7Types::frame_t &slot = slots[h & (depth - 1)];
+          for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+            slot.band[k] = bands[k];
+          }
+          slot.sequence = sequence;
+          MSGEQ7_MEMORY_BARRIER();
+          head = h + 1;
+          return true;
+        }
+
+        /*! @brief  Pop the oldest frame from the ring (consumer side only)
+        *
+        * @param    frame   The frame to copy the oldest queued frame to
+        * @returns  bool    'True' if a frame was copied to `frame`
+        */
+        bool pop(MSGEQ7Types::frame_t &frame) {
+          uint8_t t = tail;
+          if (head == t) {
+            return false;
+          }
+          MSGEQ7_MEMORY_BARRIER();
+          this->consume(slots[t & (depth - 1)], frame);
+          MSGEQ7_MEMORY_BARRIER();
+          tail = t + 1;
+          return true;
+        }
+
+        /*! @brief  Pop the newest queued frame and discard any older ones (consumer side only)
+        *
+        * @details Frames produced while the ring was full were dropped, not queued, so
+        *          the newest queued frame may be older than the latest produced one
+        *
+        * @param    frame   The frame to copy the newest queued frame to
+        * @returns  bool    'True' if a frame was copied to `frame`
+        */
+        bool popNewest(MSGEQ7Types::frame_t &frame) {
+          uint8_t h = head;
+          if (h == tail) {
+            return false;
+          }
+          MSGEQ7_MEMORY_BARRIER();
+          this->consume(slots[(uint8_t)(h - 1) & (depth - 1)], frame);
+          MSGEQ7_MEMORY_BARRIER();
+          tail = h;
+          return true;
+        }
+
+        /*! @brief  Number of frames queued and not yet popped */
+        uint8_t available(void) {
+          return (uint8_t)(head - tail);
+        }
+
+        /*! @brief  Number of frames the consumer never received (dropped or skipped) */
+        uint16_t lost(void) {
+          return lost_count;
+        }
+
+      private:
+        MSGEQ7Types::frame_t slots[depth];
+        volatile uint8_t head;
+        volatile uint8_t tail;
+
+        // producer-owned frame counter
+        uint16_t sequence;
+
+        // consumer-owned gap tracking
+        uint16_t last_sequence;
+        uint16_t lost_count;
+
+        void consume(const MSGEQ7Types::frame_t &slot, MSGEQ7Types::frame_t &frame) {
+          frame = slot;
+          lost_count += (uint16_t)(frame.sequence - last_sequence - 1);
+          last_sequence = frame.sequence;
+        }
+    };
+
     class MSGEQ7 {
       public:
         MSGEQ7(uint8_t strobe_p, uint8_t dc_out, uint8_t reset_p, bool use_input_pullup);
 
+        /*! @brief Class constructor
+        *
+        * @details In `ADC_ASYNC` mode the conversion of each band is started once DC_OUT
+        *          has settled, STROBE is released as soon as the ADC has sampled, and the
+        *          result is collected while the next strobe window settles. This needs the
+        *          default analog reference, and falls back to `ADC_BLOCKING` when
+        *          `MSGEQ7_ASYNC_ADC_SUPPORTED` is false.
+        *          In `ADC_OVERSAMPLED` mode each band is sampled `MSGEQ7_OVERSAMPLE_COUNT` times
+        *          within its strobe window and reduced to a mean or median using shifts only.
+        * 
+        * @param strobe_p          The microcontroller pin connected to the device STROBE input
+        * @param dc_out            The analog pin connected to the device DC_OUT output
+        * @param reset_p           The microcontroller pin connected to the device RESET input
+        * @param use_input_pullup  Enable the input pullup on `dc_out`
+        * @param adc_mode          The ADC conversion mode used for sampling DC_OUT
+        */
+        MSGEQ7(uint8_t strobe_p, uint8_t dc_out, uint8_t reset_p, bool use_input_pullup, 
+               MSGEQ7Types::adc_mode_t adc_mode);
+
         void     init(void);
         uint16_t mean(uint16_t array_values[], const size_t array_size);
+
+        /*! @brief  Read a fresh spectral frame
+        *
+        * @details Discards any queued frames and drives `update()` until a frame sampled
+        *          entirely after this call is complete, so the result is never stale. If
+        *          `update()` is called from a timer interrupt (`ADC_ASYNC` mode only), use
+        *          `available()` and `getFrame()` from the main loop instead.
+        * 
+        * @param    array_values  An array of seven uint16_t values to write the frame to
+        * @param    array_size    The size of the array as returned by sizeof()
+        */
         void     read(uint16_t array_values[], const size_t array_size);
 
+        /*! @brief  Advance the non-blocking sampling sequence
+        *
+        * @details Steps through the reset/strobe sequence and samples one band per
+        *          strobe window. In `ADC_BLOCKING` mode the step that samples a band
+        *          blocks for one `analogRead()` (~MSGEQ7_ANALOGREAD_MICROS), and in
+        *          `ADC_OVERSAMPLED` mode for `MSGEQ7_OVERSAMPLE_COUNT` of them, so call it
+        *          from the main loop in those modes. Only `ADC_ASYNC` never blocks, and can
+        *          also be driven from a periodic timer interrupt. Every 50-100 microseconds
+        *          suits a 16 MHz AVR, where each call takes ~10 microseconds. The timings
+        *          are minimums, so a slower period only lengthens the frame.
+        * 
+        * @returns bool  'True' if a complete frame is waiting in the frame ring
+        */
+        bool     update(void);
+
+        /*! @brief  Check if a complete frame is ready to be collected
+        *
+        * @returns bool  'True' if the frame ring holds at least one frame
+        */
+        bool     available(void);
+
+        /*! @brief  Collect the newest frame in the frame ring
+        *
+        * @details Pop the newest queued frame, discarding any older frames. When the ring
+        *          is full `update()` drops each new frame, so after the consumer stalls
+        *          this is the last frame queued before the ring filled, not the most
+        *          recently sampled one. Collect frames at least as often as they are
+        *          produced, and check `lostFrames()` to detect drops. Use `read()` for
+        *          a fresh frame.
+        * 
+        * @param    array_values  An array of seven uint16_t values to write the frame to
+        * @param    array_size    The size of the array as returned by sizeof()
+        * @returns  bool          'True' if a complete frame was copied to `array_values`
+        */
+        bool     getFrame(uint16_t array_values[], const size_t array_size);
+
+        /*! @brief  Collect the newest frame in the frame ring and its sequence number
+        *
+        * @details Same drop-on-full policy as `getFrame(array_values, array_size)`, the
+        *          sequence number shows how old the frame is
+        * 
+        * @param    latest  The frame to copy the newest frame to
+        * @returns  bool    'True' if a complete frame was copied to `latest`
+        */
+        bool     getFrame(MSGEQ7Types::frame_t &latest);
+
+        /*! @brief  Number of completed frames that were dropped or skipped by the consumer */
+        uint16_t lostFrames(void);
+
+        /*! @brief  Set the per-band loudness weighting applied as each band is sampled
+        *
+        * @param    weights   A weighting table with static storage (e.g. Weighting::ISO226_60Phon),
+        *                     or nullptr to disable weighting
+        */
+        void     setWeighting(const MSGEQ7Types::band_weights_t *weights);
+
       private:
         const uint8_t strobe_p;
         const uint8_t dc_out;
         const uint8_t reset_p;
         const bool    use_input_pullup;
+        const MSGEQ7Types::adc_mode_t adc_mode;
+
+        // per-band loudness weighting applied as each band is sampled
+        const MSGEQ7Types::band_weights_t *weights;
+
+        // ADC channel of `dc_out` and pending conversion flag used in ADC_ASYNC mode
+        uint8_t  adc_channel;
+        bool     adc_pending;
+
+        // state of the non-blocking sampling sequence used by update()
+        MSGEQ7Types::sample_state_t sample_state;
+        uint8_t  sample_band;
+        uint32_t sample_timestamp;
+
+        // frame buffer written by update(), pushed to the frame ring when complete
+        uint16_t frame[MSGEQ7_BAND_COUNT];
+        FrameRing<MSGEQ7_FRAME_RING_DEPTH> frames;
+
+        void     adcStart(void);
+        bool     adcComplete(void);
+        uint16_t adcResult(void);
+        uint16_t oversample(void);
+    };
+
+    /*! @brief Per-band envelope follower and peak hold for MSGEQ7 frames
+    *
+    * @details Each band has a one-pole attack/release envelope kept in Q16.16 fixed
+    *          point, where the attack and release time constants are ~2^shift frames,
+    *          and a peak that is held for a number of frames then falls off linearly.
+    *          Updating is O(7) per frame with no allocation.
+    */
+    class Envelope {
+      public:
+        Envelope(void);
+        Envelope(uint8_t attack_shift, uint8_t release_shift, 
+                 uint8_t peak_hold_frames, uint16_t peak_falloff);
+
+        /*! @brief  Set the envelope time constants and peak hold behaviour
+        *
+        * @param attack_shift      Attack time constant as a shift count, 0 follows rises instantly
+        * @param release_shift     Release time constant as a shift count, 0 follows falls instantly
+        * @param peak_hold_frames  Number of frames a new peak is held before falling off
+        * @param peak_falloff      Amount subtracted from a held peak each frame once the hold expires
+        */
+        void     configure(uint8_t attack_shift, uint8_t release_shift, 
+                           uint8_t peak_hold_frames, uint16_t peak_falloff);
+
+        /*! @brief  Clear the envelope and peak state of every band */
+        void     reset(void);
+
+        /*! @brief  Update every band from a new frame
+        *
+        * @param    array_values  A frame of seven band levels, e.g. from `MSGEQ7::read()`
+        * @param    array_size    The size of the array as returned by sizeof()
+        */
+        void     update(const uint16_t array_values[], const size_t array_size);
+
+        /*! @brief  Smoothed envelope level of a band (0-6) */
+        uint16_t level(const uint8_t band);
+
+        /*! @brief  Held peak level of a band (0-6) */
+        uint16_t peak(const uint8_t band);
+
+        /*! @brief  Copy the smoothed envelope level of every band to `array_values` */
+        void     getLevels(uint16_t array_values[], const size_t array_size);
+
+        /*! @brief  Copy the held peak level of every band to `array_values` */
+        void     getPeaks(uint16_t array_values[], const size_t array_size);
+
+      private:
+        uint8_t  attack_shift;
+        uint8_t  release_shift;
+        uint8_t  peak_hold_frames;
+        uint16_t peak_falloff;
+
+        uint32_t envelope[MSGEQ7_BAND_COUNT];
+        uint16_t peak_level[MSGEQ7_BAND_COUNT];
+        uint8_t  peak_hold[MSGEQ7_BAND_COUNT];
+    };
+
+    /*! @brief  Integer square root of a 32-bit value */
+    uint16_t isqrt32(uint32_t value);
+
+    /*! @brief Windowed running statistics of MSGEQ7 frames
+    *
+    * @details Keeps the last `window` frames and per-band running sums, so each
+    *          `update()` is O(7) and every mean, RMS and variance query is O(1),
+    *          per band or across all bands. Sums use 32-bit accumulators, with
+    *          squares accumulated at 1/256 scale so a full window of 0xFFFF levels
+    *          cannot overflow. RAM use is (14 * window + 66) bytes.
+    */
+    template <uint8_t window>
+    class RunningStats {
+      static_assert((window >= 2) && (window <= 32) && ((window & (window - 1)) == 0), 
+                    "RunningStats window must be a power of two between 2 and 32");
+
+      public:
+        RunningStats(void) { this->reset(); }
+
+        /*! @brief  Clear the frame history and all running sums */
+        void reset(void) {
+          memset(history, 0, sizeof(history));
+          memset(sum, 0, sizeof(sum));
+          memset(sum_sq, 0, sizeof(sum_sq));
+          total_sum = 0;
+          total_sum_sq = 0;
+          index = 0;
+          count = 0;
+        }
+
+        /*! @brief  Add a frame to the window, replacing the oldest frame once full
+        *
+        * @param    array_values  A frame of seven band levels, e.g. from `MSGEQ7::read()`
+        * @param    array_size    The size of the array as returned by sizeof()
+        */
+        void update(const uint16_t array_values[], const size_t array_size) {
+          if ((uint16_t)array_size != (uint16_t)14) {
+            return;
+          }
+          uint16_t *oldest = history[index];
+          for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+            uint32_t old_sq = ((uint32_t)oldest[k] * oldest[k]) >> 8;
+            uint32_t new_sq = ((uint32_t)array_values[k] * array_values[k]) >> 8;
+            sum[k] = sum[k] - oldest[k] + array_values[k];
+            sum_sq[k] = sum_sq[k] - old_sq + new_sq;
+            total_sum = total_sum - oldest[k] + array_values[k];
+            total_sum_sq = total_sum_sq - old_sq + new_sq;
+            oldest[k] = array_values[k];
+          }
+          index = (index + 1) & (window - 1);
+          if (count < window) {
+            count++;
+          }
+        }
+
+        /*! @brief  Number of frames currently in the window */
+        uint8_t  frames(void) { return count; }
+
+        /*! @brief  Windowed mean of a band (0-6) */
+        uint16_t mean(const uint8_t band) {
+          return (uint16_t)this->average(sum[band], count);
+        }
+
+        /*! @brief  Windowed RMS of a band (0-6) */
+        uint16_t rms(const uint8_t band) {
+          return isqrt32(this->average(sum_sq[band], count) << 8);
+        }
+
+        /*! @brief  Windowed variance of a band (0-6) */
+        uint32_t variance(const uint8_t band) {
+          return this->variance(sum[band], sum_sq[band], count);
+        }
+
+        /*! @brief  Windowed mean across all bands */
+        uint16_t mean(void) {
+          return (uint16_t)(this->average(total_sum, count) / MSGEQ7_BAND_COUNT);
+        }
+
+        /*! @brief  Windowed RMS across all bands */
+        uint16_t rms(void) {
+          return isqrt32((this->average(total_sum_sq, count) / MSGEQ7_BAND_COUNT) << 8);
+        }
+
+        /*! @brief  Windowed variance across all bands */
+        uint32_t variance(void) {
+          uint32_t n = (uint32_t)count * MSGEQ7_BAND_COUNT;
+          return this->variance(total_sum, total_sum_sq, n);
+        }
+
+      private:
+        uint16_t history[window][MSGEQ7_BAND_COUNT];
+        uint32_t sum[MSGEQ7_BAND_COUNT];
+        uint32_t sum_sq[MSGEQ7_BAND_COUNT];
+        uint32_t total_sum;
+        uint32_t total_sum_sq;
+        uint8_t  index;
+        uint8_t  count;
+
+        // divide by the number of samples, a shift once the window is full
+        uint32_t average(const uint32_t value, const uint32_t n) {
+          if (n == window) {
+            return value / window;
+          }
+          return (n != 0) ? (value / n) : 0;
+        }
+
+        // (n * sum(x^2) - sum(x)^2) / n^2, where the sum of squares is kept at 1/256 scale,
+        // evaluated in 64 bits so the truncated mean does not bias the result
+        uint32_t variance(const uint32_t s, const uint32_t s_sq, const uint32_t n) {
+          if (n == 0) {
+            return 0;
+          }
+          uint64_t n_sum_sq = ((uint64_t)s_sq << 8) * n;
+          uint64_t sum_2 = (uint64_t)s * s;
+          return (n_sum_sq > sum_2) ? (uint32_t)((n_sum_sq - sum_2) / ((uint64_t)n * n)) : 0;
+        }
+    };
+
+    /*! @brief Spectral flux onset (beat) detector for MSGEQ7 frames
+    *
+    * @details The onset function is the half-wave rectified spectral flux, the sum
+    *          of band level increases since the previous frame. A beat is reported
+    *          when the flux exceeds an adaptive threshold, the mean flux over the
+    *          last `MSGEQ7_ONSET_HISTORY` frames scaled by a Q4.4 sensitivity plus a
+    *          minimum flux, and at least the refractory time has passed since the
+    *          previous beat. Each update is O(7) with a running sum for the mean.
+    */
+    class OnsetDetector {
+      public:
+        OnsetDetector(void);
+        OnsetDetector(uint8_t sensitivity, uint16_t minimum_flux, uint16_t refractory_millis);
+
+        /*! @brief  Set the adaptive threshold and refractory time
+        *
+        * @param sensitivity        Threshold multiplier over the mean flux in Q4.4 (16 = 1.0)
+        * @param minimum_flux       Flux that must be exceeded in addition to the scaled mean
+        * @param refractory_millis  Minimum time between reported beats (in milliseconds)
+        */
+        void     configure(uint8_t sensitivity, uint16_t minimum_flux, uint16_t refractory_millis);
+
+        /*! @brief  Clear the flux history and previous frame, no beats are reported until
+        *           the history has been refilled */
+        void     reset(void);
+
+        /*! @brief  Update the detector with a new frame
+        *
+        * @param    array_values  A frame of seven band levels, e.g. from `MSGEQ7::read()`
+        * @param    array_size    The size of the array as returned by sizeof()
+        * @param    timestamp     The time the frame was read (in milliseconds, e.g. millis())
+        * @returns  bool          'True' if a beat was detected in this frame
+        */
+        bool     update(const uint16_t array_values[], const size_t array_size, 
+                        const uint32_t timestamp);
+
+        /*! @brief  The most recently detected beat */
+        MSGEQ7Types::beat_event_t lastBeat(void);
+
+        /*! @brief  Number of beats detected since the last reset */
+        uint16_t beats(void);
+
+        /*! @brief  Spectral flux of the most recent frame */
+        uint16_t flux(void);
+
+        /*! @brief  Adaptive threshold the most recent frame was compared against */
+        uint16_t threshold(void);
+
+      private:
+        uint8_t  sensitivity;
+        uint16_t minimum_flux;
+        uint16_t refractory_millis;
+
+        uint16_t previous[MSGEQ7_BAND_COUNT];
+        uint16_t flux_history[MSGEQ7_ONSET_HISTORY];
+        uint32_t flux_sum;
+        uint8_t  flux_index;
+        uint8_t  flux_frames;
+
+        uint16_t flux_current;
+        uint16_t threshold_current;
+        uint16_t beat_count;
+        MSGEQ7Types::beat_event_t last_beat;
+    };
+
+    /*! @brief MSGEQ7 reader for several devices sharing STROBE and RESET
+    *
+    * @details Drives the shared reset/strobe sequence once per frame and samples the
+    *          DC_OUT pin of every device within each strobe window, so reading N
+    *          devices costs one strobe sequence instead of N.
+    */
+    template <uint8_t channels>
+    class MSGEQ7Multi {
+      static_assert(channels >= 1, "MSGEQ7Multi needs at least one channel");
+
+      public:
+        MSGEQ7Multi(uint8_t strobe_p, const uint8_t (&dc_out)[channels], uint8_t reset_p, 
+                    bool use_input_pullup);
+
+        void     init(void);
+
+        /*! @brief  Read spectral band data from all devices in a single strobe sequence
+        *
+        * @details Band levels are interleaved by band, i.e. `array_values[band * channels + ch]`
+        * 
+        * @param    array_values  An array of (channels * 7) uint16_t values to write to
+        * @param    array_size    The size of the array as returned by sizeof()
+        */
+        void     read(uint16_t array_values[], const size_t array_size);
+
+        /*! @brief  Set the per-band loudness weighting applied as each band is sampled
+        *
+        * @param    weights   A weighting table with static storage (e.g. Weighting::ISO226_60Phon),
+        *                     or nullptr to disable weighting
+        */
+        void     setWeighting(const MSGEQ7Types::band_weights_t *weights) {
+          this->weights = weights;
+        }
+
+      private:
+        const uint8_t strobe_p;
+        const uint8_t reset_p;
+        const bool    use_input_pullup;
+        uint8_t dc_out[channels];
+        const MSGEQ7Types::band_weights_t *weights;
     };
+
+    // class constructor for MSGEQ7Multi object
+    template <uint8_t channels>
+    MSGEQ7Multi<channels>::MSGEQ7Multi(uint8_t strobe_p, const uint8_t (&dc_out)[channels], 
+                                       uint8_t reset_p, bool use_input_pullup) :
+      strobe_p(strobe_p), 
+      reset_p(reset_p), 
+      use_input_pullup(use_input_pullup),
+      weights(&Weighting::ISO226_60Phon) {
+      memcpy(this->dc_out, dc_out, channels);
+    }
+
+    // initialize the shared MSGEQ7 reset and strobe signals and every DC_OUT input
+    template <uint8_t channels>
+    void MSGEQ7Multi<channels>::init(void) {
+      pinMode(strobe_p, OUTPUT);
+      pinMode(reset_p,  OUTPUT);
+
+      // set MSGEQ7 strobe low, and reset high (put devices in standby)
+      digitalWrite(strobe_p, HIGH);
+      digitalWrite(reset_p, HIGH);
+
+      for (uint8_t ch = 0; ch < channels; ch++) {
+        pinMode(dc_out[ch], (use_input_pullup ? INPUT_PULLUP : INPUT));
+      }
+    }
+
+    // read spectral band data from every MSGEQ7 and write interleaved to `read_array`
+    template <uint8_t channels>
+    void MSGEQ7Multi<channels>::read(uint16_t read_array[], const size_t array_size) {
+      if (array_size != (sizeof(uint16_t) * MSGEQ7_BAND_COUNT * channels)) {
+        // the array must hold 7 spectral bands for every channel
+        // if this is not the case then don't do anything and just return
+        return;
+      }
+
+      // start by setting RESET pin low to enable output
+      digitalWrite(reset_p, LOW);
+      delayMicroseconds(MSGEQ7_RESET_DELAY_MICROS);
+
+      // pulse STROBE pin once per band, and read all devices in each strobe window
+      for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+        // set STROBE pin low to enable output
+        digitalWrite(strobe_p, LOW);
+        delayMicroseconds(MSGEQ7_STROBE_SETTLE_MICROS);
+
+        // read signal band level, and apply the loudness weighting
+        for (uint8_t ch = 0; ch < channels; ch++) {
+          read_array[(k * channels) + ch] = weightBand(analogRead(dc_out[ch]) << 3, k, weights);
+        }
+
+        // set STROBE pin high again to prepare for next band reading
+        digitalWrite(strobe_p, HIGH);
+        delayMicroseconds(MSGEQ7_STROBE_HOLD_MICROS);
+      }
+
+      // set RESET high again to reset MSGEQ7 multiplexers
+      digitalWrite(reset_p, HIGH);
+    }
+
+    /*! @brief MSGEQ7 reader with its pins fixed at compile time
+    *
+    * @details Same sequence as the blocking `MSGEQ7::read()`, but STROBE and RESET
+    *          edges compile to single port writes (see FastGPIO::Pin)
+    */
+    template <uint8_t strobe_p, uint8_t dc_out, uint8_t reset_p>
+    class MSGEQ7Pins {
+      public:
+        MSGEQ7Pins(bool use_input_pullup) : 
+          use_input_pullup(use_input_pullup), 
+          weights(&Weighting::ISO226_60Phon) { }
+
+        void     init(void);
+        void     read(uint16_t array_values[], const size_t array_size);
+
+        /*! @brief  Set the per-band loudness weighting applied as each band is sampled
+        *
+        * @param    weights   A weighting table with static storage (e.g. Weighting::ISO226_60Phon),
+        *                     or nullptr to disable weighting
+        */
+        void     setWeighting(const MSGEQ7Types::band_weights_t *weights) {
+          this->weights = weights;
+        }
+
+      private:
+        typedef FastGPIO::Pin<strobe_p> strobe;
+        typedef FastGPIO::Pin<reset_p>  reset;
+
+        const bool use_input_pullup;
+        const MSGEQ7Types::band_weights_t *weights;
+    };
+
+    // initialize the MSGEQ7 reset and strobe signals
+    template <uint8_t strobe_p, uint8_t dc_out, uint8_t reset_p>
+    void MSGEQ7Pins<strobe_p, dc_out, reset_p>::init(void) {
+      strobe::mode(OUTPUT);
+      reset::mode(OUTPUT);
+
+      // set MSGEQ7 strobe low, and reset high (put device in standby)
+      strobe::high();
+      reset::high();
+
+      pinMode(dc_out, (use_input_pullup ? INPUT_PULLUP : INPUT));
+    }
+
+    // read spectral band data from the MSGEQ7 and write to `read_array`
+    template <uint8_t strobe_p, uint8_t dc_out, uint8_t reset_p>
+    void MSGEQ7Pins<strobe_p, dc_out, reset_p>::read(uint16_t read_array[], 
+                                                     const size_t array_size) {
+      if ((uint16_t)array_size != (uint16_t)14) {
+        // there are 7 spectral bands so the array size must be 14 bytes
+        // if this is not the case then don't do anything and just return
+        return;
+      }
+
+      // start by setting RESET pin low to enable output
+      reset::low();
+      delayMicroseconds(MSGEQ7_RESET_DELAY_MICROS);
+
+      // pulse STROBE pin to read all 7 frequency bands
+      for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+        // set STROBE pin low to enable output
+        strobe::low();
+        delayMicroseconds(MSGEQ7_STROBE_SETTLE_MICROS);
+
+        // read signal band level, and apply the loudness weighting
+        read_array[k] = weightBand(analogRead(dc_out) << 3, k, weights);
+
+        // set STROBE pin high again to prepare for next band reading
+        strobe::high();
+        delayMicroseconds(MSGEQ7_STROBE_HOLD_MICROS);
+      }
+
+      // set RESET high again to reset MSGEQ7 multiplexer
+      reset::high();
+    }
   }
 
 #endif
@@ -0,0 +1,68 @@
+/*
+ * VolumeBalance.cpp - Volume and Balance Control for Digital Potentiometers for Arduino
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "VolumeBalance.h"
+
+namespace VolumeBalance {
+  // AD5290 wiper position for each 1 dB of attenuation, 255 * 10^(-dB / 20), where the
+  // last entry mutes the channel
+  static const uint8_t wiper_taper[VOLUMEBALANCE_MUTE_ATTENUATION + 1] PROGMEM =
+  {
+    255, 227, 203, 181, 161, 143, 128, 114,
+    102, 90,  81,  72,  64,  57,  51,  45,
+    40,  36,  32,  29,  26,  23,  20,  18,
+    16,  14,  13,  11,  10,  9,   8,   7,
+    6,   6,   5,   5,   4,   4,   3,   3,
+    3,   2,   2,   2,   2,   1,   1,   1,
+    1,   1,   1,   1,   1,   1,   1,   0,
+    0,   0,   0,   0,   0,   0,   0,   0
+  };
+
+  // attenuate the channel on the quieter side of the balance by the balance offset
+  uint8_t channelAttenuation(const uint8_t master, const int8_t balance, const bool right) {
+    int16_t attenuation = master;
+    if (right && (balance < 0)) {
+      attenuation = attenuation - balance;
+    }
+    else if (!right && (balance > 0)) {
+      attenuation = attenuation + balance;
+    }
+    return (attenuation > VOLUMEBALANCE_MUTE_ATTENUATION) ? 
+            VOLUMEBALANCE_MUTE_ATTENUATION : (uint8_t)attenuation;
+  }
+
+  // look up the wiper position of an attenuation in the taper table
+  uint8_t attenuationToWiper(const uint8_t attenuation) {
+    if (attenuation >= VOLUMEBALANCE_MUTE_ATTENUATION) {
+      return AD5290_MINIMUM_WIPER_VALUE;
+    }
+    return pgm_read_byte(&(wiper_taper[attenuation]));
+  }
+
+  /**************************************************************************/
+
+  // class constructor for DS1882Balance object
+  DS1882Balance::DS1882Balance(DS1882::DS1882 &pot) : 
+    pot(pot) { }
+
+  // write the left and right channel attenuation in one transaction
+  bool DS1882Balance::set(const uint8_t master, const int8_t balance) {
+    return pot.set(channelAttenuation(master, balance, false), 
+                   channelAttenuation(master, balance, true));
+  }
+}
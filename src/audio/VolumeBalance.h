@@ -0,0 +1,111 @@
+/*
+ * VolumeBalance.h - Volume and Balance Control for Digital Potentiometers for Arduino
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef VOLUME_BALANCE_H
+#define VOLUME_BALANCE_H
+
+  #include <Arduino.h>
+  #include "DS1882.h"
+  #include "../analog/AD5290.h"
+
+  // attenuation range in 1 dB steps, the maximum attenuation mutes the channel
+  #define VOLUMEBALANCE_MINIMUM_ATTENUATION ((uint8_t) 0U)
+  #define VOLUMEBALANCE_MUTE_ATTENUATION    ((uint8_t)63U)
+
+  namespace VolumeBalance {
+    /*! @brief  Attenuation of one channel from the master attenuation and balance
+    *
+    * @details A positive balance attenuates the left channel and a negative balance the
+    *          right channel, by one 1 dB step per unit, so the louder side stays at the
+    *          master level
+    * 
+    * @param    master    The master attenuation in dB (0-63)
+    * @param    balance   The balance offset in dB, positive towards the right channel
+    * @param    right     'True' for a right channel, 'False' for a left channel
+    * @returns  uint8_t   The channel attenuation in dB (0-63)
+    */
+    uint8_t channelAttenuation(const uint8_t master, const int8_t balance, const bool right);
+
+    /*! @brief  Convert an attenuation to an AD5290 wiper position with a log taper table
+    *
+    * @param    attenuation  The attenuation in dB (0-63), 63 mutes the channel
+    * @returns  uint8_t      The wiper position (0-255) giving that attenuation on a linear pot
+    */
+    uint8_t attenuationToWiper(const uint8_t attenuation);
+
+    /*! @brief Volume and balance control for the two potentiometers of a DS1882
+    *
+    * @details Potentiometer 0 is the left channel and potentiometer 1 the right channel.
+    *          DS1882 steps are already 1 dB, so the channel attenuation is written as the
+    *          potentiometer setting, both channels in a single transaction.
+    */
+    class DS1882Balance {
+      public:
+        DS1882Balance(DS1882::DS1882 &pot);
+
+        /*! @brief  Set the master attenuation and balance
+        *
+        * @param    master    The master attenuation in dB (0-63)
+        * @param    balance   The balance offset in dB, positive towards the right channel
+        * @returns  bool      'True' if the register write was successful
+        */
+        bool     set(const uint8_t master, const int8_t balance);
+
+      private:
+        DS1882::DS1882 &pot;
+    };
+
+    /*! @brief Volume and balance control for a daisy-chain of AD5290
+    *
+    * @details Devices are paired as stereo channels, even positions in the chain are
+    *          left channels and odd positions right channels. Each channel attenuation is
+    *          mapped through a log taper table and the whole chain is written in a single
+    *          SPI transaction.
+    */
+    template <uint8_t devices>
+    class AD5290Balance {
+      public:
+        AD5290Balance(AD5290::AD5290<devices> &chain) : 
+          chain(chain) { }
+
+        /*! @brief  Set the master attenuation and balance of every device in the chain
+        *
+        * @param    master    The master attenuation in dB (0-63)
+        * @param    balance   The balance offset in dB, positive towards the right channel
+        * @returns  bool      'True' if the chain write was successful
+        */
+        bool     set(const uint8_t master, const int8_t balance);
+
+      private:
+        AD5290::AD5290<devices> &chain;
+    };
+
+    // build the wiper position of every device then write the chain in one transaction
+    template <uint8_t devices>
+    bool AD5290Balance<devices>::set(const uint8_t master, const int8_t balance) {
+      uint8_t wipers[devices];
+      uint8_t left = attenuationToWiper(channelAttenuation(master, balance, false));
+      uint8_t right = attenuationToWiper(channelAttenuation(master, balance, true));
+      for (uint8_t k = 0; k < devices; k++) {
+        wipers[k] = (k & 0x01) ? right : left;
+      }
+      return chain.set(wipers, devices);
+    }
+  }
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * decaybuffer.h - Running-sum Level Decay Buffer for Arduino
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DECAY_BUFFER_H
+#define DECAY_BUFFER_H
+
+  #include <Arduino.h>
+
+  namespace DecayBuffer {
+    /*! @brief Circular buffer of decaying levels with an O(1) running mean
+    *
+    * @details Each update attacks or decays one slot of the buffer, the same as
+    *          `MAX9744::decayBuffer32()`, but keeps a running sum that is adjusted
+    *          by the change to that slot instead of re-summing the whole buffer.
+    *          The buffer owns its storage and `size` must be a power of two, so the
+    *          mean is a shift.
+    */
+    template <uint8_t size>
+    class DecayBuffer {
+      static_assert((size >= 2) && (size <= 128) && ((size & (size - 1)) == 0),
+                    "DecayBuffer size must be a power of two between 2 and 128");
+
+      public:
+        DecayBuffer(void) { this->fill(0); }
+
+        /*! @brief  Set every slot of the buffer to `value` */
+        void fill(const uint16_t value) {
+          for (uint8_t k = 0; k < size; k++) {
+            buffer[k] = value;
+          }
+          sum = (uint32_t)value * size;
+          index = 0;
+        }
+
+        /*! @brief  Update the next slot of the buffer and return the buffer mean
+        *
+        * @details If the new level is greater than the slot, the slot moves halfway to it.
+        *          If the new level is under ~12% above the nominal zero signal level there
+        *          is probably no significant audio, so the slot is left as it is. Otherwise
+        *          the slot decays by ~3%.
+        *
+        * @param    data_mean                  The latest audio level, e.g. `MSGEQ7::mean()`
+        * @param    nominal_zero_signal_level  The audio level measured with no signal present
+        * @returns  uint16_t                   The mean of every slot in the buffer
+        */
+        uint16_t update(const uint16_t data_mean, const uint16_t nominal_zero_signal_level) {
+          uint16_t previous = buffer[index];
+          uint16_t current = previous;
+
+          if (data_mean > previous) {
+            // if the new value is greater, use value halfway between old and new
+            current = previous + ((data_mean - previous) >> 1);
+          }
+          else if (data_mean < ((nominal_zero_signal_level * (uint16_t)18) >> 4)) {
+            // if the latest level is less a small % over the nominal zero signal,
+            // there's probs no significant audio signal so don't update buffer
+          }
+          else {
+            // otherwise, decay the current value by approximately 3%
+            current = ((uint32_t)previous * 31UL) >> 5;
+          }
+
+          buffer[index] = current;
+          sum = sum - previous + current;
+          index = (index + 1) & (size - 1);
+
+          return this->mean();
+        }
+
+        /*! @brief  The mean of every slot in the buffer */
+        uint16_t mean(void) {
+          return (uint16_t)(sum / size);
+        }
+
+      private:
+        uint16_t buffer[size];
+        uint32_t sum;
+        uint8_t  index;
+    };
+  }
+
+#endif
@@ -19,6 +19,8 @@
 #ifndef LED_BUTTON_H
 #define LED_BUTTON_H
 
+  #include "fastgpio.h"
+
   namespace ButtonLED {
     class LED {
       public:
@@ -66,6 +68,98 @@
       private:
         LED led;
     };
+
+
+    /*! @brief LED with its pin fixed at compile time
+    *
+    * @details on/off compile to a single port write (see FastGPIO::Pin). A port write
+    *          doesn't disconnect a PWM output, so the first on/off/toggle after
+    *          `brightness()` goes through digitalWrite() to turn PWM off.
+    */
+    template <uint8_t led_pin>
+    class LEDPin {
+      public:
+        LEDPin(void) : pwm_active(false) { }
+
+        void brightness(const uint8_t value) {
+          analogWrite(led_pin, value);
+          pwm_active = true;
+        }
+
+        void init(void) {
+          FastGPIO::Pin<led_pin>::mode(OUTPUT);
+          pwm_active = true;    // the pin may have been left as a PWM output
+          this->off();
+        }
+
+        void off(void) {
+          if (pwm_active) {
+            this->stopPWM(LOW);
+          }
+          else {
+            FastGPIO::Pin<led_pin>::low();
+          }
+        }
+
+        void on(void) {
+          if (pwm_active) {
+            this->stopPWM(HIGH);
+          }
+          else {
+            FastGPIO::Pin<led_pin>::high();
+          }
+        }
+
+        void toggle(void) {
+          if (pwm_active) {
+            this->stopPWM(!FastGPIO::Pin<led_pin>::read());
+          }
+          else {
+            FastGPIO::Pin<led_pin>::toggle();
+          }
+        }
+
+      private:
+        bool pwm_active;
+
+        // digitalWrite() clears the timer output compare bits, disconnecting PWM from the pin
+        void stopPWM(const uint8_t value) {
+          digitalWrite(led_pin, value);
+          pwm_active = false;
+        }
+    };
+
+
+    /*! @brief Button with its pin fixed at compile time
+    *
+    * @details Same as Button, but read() compiles to a single port read (see FastGPIO::Pin)
+    */
+    template <uint8_t button_pin>
+    class ButtonPin {
+      public:
+        ButtonPin(void) : button_port_input_mode(INPUT) { }
+
+        void disableInputPullup(void) {
+          button_port_input_mode = INPUT;
+          this->init();
+        }
+
+        void enableInputPullup(void) {
+          button_port_input_mode = INPUT_PULLUP;
+          this->init();
+        }
+
+        void init(void) {
+          FastGPIO::Pin<button_pin>::mode(button_port_input_mode);
+        }
+
+        bool read(void) {
+          return FastGPIO::Pin<button_pin>::read();
+        }
+
+      private:
+        uint8_t button_port_input_mode;
+    };
   }
 
 #endif
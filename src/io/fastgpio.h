@@ -0,0 +1,117 @@
+/*
+ * fastgpio.h - Compile-time GPIO Pin Access for Arduino
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+  #include <Arduino.h>
+
+  // pin-to-port mapping is resolved at compile time for the ATmega328P/168 family (Uno, Nano,
+  // Pro Mini), on other targets the Pin class falls back to digitalWrite() and digitalRead()
+  #if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+      defined(__AVR_ATmega168__)  || defined(__AVR_ATmega168P__)
+    #define FASTGPIO_PORT_MAP (true )
+  #else
+    #define FASTGPIO_PORT_MAP (false)
+  #endif
+
+  namespace FastGPIO {
+    /*! @brief Digital pin with its port and bit mask resolved at compile time
+    *
+    * @details With a constant pin number each write compiles to a single `sbi`/`cbi`
+    *          instruction (2 cycles) instead of the ~50-70 cycle pin table lookups done
+    *          by digitalWrite() and digitalRead().
+    *
+    * @warning Unlike digitalWrite(), writes do not disable PWM output on the pin
+    */
+    template <uint8_t pin>
+    class Pin {
+      public:
+        /*! @brief  Configure the pin direction and pullup, same as pinMode() */
+        static inline void mode(const uint8_t mode) {
+          pinMode(pin, mode);
+        }
+
+        /*! @brief  Set the pin output HIGH */
+        static inline void high(void) {
+#if FASTGPIO_PORT_MAP
+          port() |= mask();
+#else
+          digitalWrite(pin, HIGH);
+#endif
+        }
+
+        /*! @brief  Set the pin output LOW */
+        static inline void low(void) {
+#if FASTGPIO_PORT_MAP
+          port() &= (uint8_t)~mask();
+#else
+          digitalWrite(pin, LOW);
+#endif
+        }
+
+        /*! @brief  Set the pin output to `value` */
+        static inline void write(const bool value) {
+          if (value) {
+            high();
+          }
+          else {
+            low();
+          }
+        }
+
+        /*! @brief  Invert the pin output */
+        static inline void toggle(void) {
+#if FASTGPIO_PORT_MAP
+          // writing a one to the PINx register toggles the PORTx bit
+          input() = mask();
+#else
+          digitalWrite(pin, !digitalRead(pin));
+#endif
+        }
+
+        /*! @brief  Read the instantaneous pin input level */
+        static inline bool read(void) {
+#if FASTGPIO_PORT_MAP
+          return (input() & mask()) != 0;
+#else
+          return (bool)digitalRead(pin);
+#endif
+        }
+
+#if FASTGPIO_PORT_MAP
+      private:
+        static_assert(pin < 20, "FastGPIO pin number is out of range for this target");
+
+        // bit mask of the pin within its port, PORTD = D0-D7, PORTB = D8-D13, PORTC = A0-A5
+        static constexpr uint8_t mask(void) {
+          return (pin < 8) ? (1 << pin) : ((pin < 14) ? (1 << (pin - 8)) : (1 << (pin - 14)));
+        }
+
+        static inline volatile uint8_t &port(void) {
+          return (pin < 8) ? PORTD : ((pin < 14) ? PORTB : PORTC);
+        }
+
+        static inline volatile uint8_t &input(void) {
+          return (pin < 8) ? PIND : ((pin < 14) ? PINB : PINC);
+        }
+#endif
+    };
+  }
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * host_test.h - Checks and Timing for the Host Tests
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+  #include <Arduino.h>
+  #include <Wire.h>
+  #include <SPI.h>
+  #include <chrono>
+  #include <stdio.h>
+  #include <vector>
+  #include "host.h"
+
+  namespace HostTest {
+    extern uint32_t checks;
+    extern uint32_t failures;
+
+    inline bool check(const bool passed, const char *expression, const char *file, const int line) {
+      checks++;
+      if (!passed) {
+        failures++;
+        printf("%s:%d: check failed: %s\n", file, line, expression);
+      }
+      return passed;
+    }
+
+    inline bool checkEqual(const long long actual, const long long expected, 
+                           const char *expression, const char *file, const int line) {
+      checks++;
+      if (actual != expected) {
+        failures++;
+        printf("%s:%d: check failed: %s is %lld, expected %lld\n", 
+               file, line, expression, actual, expected);
+      }
+      return (actual == expected);
+    }
+
+    inline bool checkBytes(const std::vector<uint8_t> &actual, const std::vector<uint8_t> &expected, 
+                           const char *expression, const char *file, const int line) {
+      checks++;
+      if (actual != expected) {
+        failures++;
+        printf("%s:%d: check failed: %s is [", file, line, expression);
+        for (size_t k = 0; k < actual.size(); k++) {
+          printf(" %02X", actual[k]);
+        }
+        printf(" ], expected [");
+        for (size_t k = 0; k < expected.size(); k++) {
+          printf(" %02X", expected[k]);
+        }
+        printf(" ]\n");
+      }
+      return (actual == expected);
+    }
+
+    /*! @brief  Host time per call of `function` over `iterations` calls, in nanoseconds
+    *
+    * @details Host timings only compare two implementations built the same way, they are
+    *          not AVR cycle counts
+    */
+    template <typename function_t>
+    double nanosPerCall(const uint32_t iterations, function_t function) {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (uint32_t k = 0; k < iterations; k++) {
+        function(k);
+      }
+      std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+      return elapsed.count() / iterations;
+    }
+
+    /*! @brief  Print the check totals, and return the process exit status */
+    inline int finish(const char *name) {
+      printf("%s: %u checks, %u failed\n", name, checks, failures);
+      return (failures == 0) ? 0 : 1;
+    }
+  }
+
+  // keep a benchmarked result alive so the optimizer can't remove the work
+  #define HOST_KEEP(value) __asm__ __volatile__("" : : "g"(value) : "memory")
+
+  #define CHECK(expression) \
+    HostTest::check((expression), #expression, __FILE__, __LINE__)
+  #define CHECK_EQUAL(actual, expected) \
+    HostTest::checkEqual((long long)(actual), (long long)(expected), #actual, __FILE__, __LINE__)
+  #define CHECK_BYTES(actual, ...) \
+    HostTest::checkBytes((actual), std::vector<uint8_t>(__VA_ARGS__), #actual, __FILE__, __LINE__)
+
+  // defines the check counters, use once per test program
+  #define HOST_TEST_MAIN() \
+    uint32_t HostTest::checks = 0; \
+    uint32_t HostTest::failures = 0
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Arduino.h - Host Stand-in for the Arduino Core, used by the host tests
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+  #include <stdint.h>
+  #include <stddef.h>
+  #include <stdlib.h>
+  #include <string.h>
+  #include <avr/pgmspace.h>
+
+  #define HIGH         (0x1)
+  #define LOW          (0x0)
+
+  #define INPUT        (0x0)
+  #define OUTPUT       (0x1)
+  #define INPUT_PULLUP (0x2)
+
+  #define A0           (14)
+  #define DEFAULT      (1)
+  #define NOT_A_PIN    (0)
+
+  #define LSBFIRST     (0)
+  #define MSBFIRST     (1)
+
+  // number of digital pins modelled by the host core
+  #define HOST_PIN_COUNT (20U)
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t value);
+  int  digitalRead(uint8_t pin);
+  int  analogRead(uint8_t pin);
+  void analogWrite(uint8_t pin, int value);
+
+  unsigned long micros(void);
+  unsigned long millis(void);
+  void delay(unsigned long ms);
+  void delayMicroseconds(unsigned int us);
+
+#if defined(__AVR_ATmega328P__)
+  // ATmega328P port model for FastGPIO, every register access is counted by the host core
+  namespace Host {
+    extern volatile uint8_t port_registers[6];
+    volatile uint8_t &portAccess(const uint8_t index);
+  }
+
+  #define PIND  (Host::portAccess(0))
+  #define PORTD (Host::portAccess(1))
+  #define PINB  (Host::portAccess(2))
+  #define PORTB (Host::portAccess(3))
+  #define PINC  (Host::portAccess(4))
+  #define PORTC (Host::portAccess(5))
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * SPI.h - Host Stand-in for the Arduino SPI Library, models a daisy-chain shift register
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+  #include <Arduino.h>
+  #include <vector>
+
+  #define SPI_MODE0 (0x00)
+  #define SPI_MODE1 (0x04)
+  #define SPI_MODE2 (0x08)
+  #define SPI_MODE3 (0x0C)
+
+  class SPISettings {
+    public:
+      SPISettings(uint32_t clock, uint8_t bit_order, uint8_t data_mode) : 
+        clock(clock), bit_order(bit_order), data_mode(data_mode) { }
+
+      uint32_t clock;
+      uint8_t  bit_order;
+      uint8_t  data_mode;
+  };
+
+  class SPIClass {
+    public:
+      void    begin(void) { }
+      void    beginTransaction(SPISettings settings);
+      void    endTransaction(void);
+      uint8_t transfer(uint8_t value);
+      void    transfer(void *buffer, size_t size);
+
+      /*! @brief  Set the length of the modelled shift register chain, cleared to `fill` */
+      void    setChain(size_t length, uint8_t fill);
+
+      /*! @brief  Forget every transaction and clear the chain */
+      void    reset(void);
+
+      // bytes clocked out in each transaction, and the number of transactions begun
+      std::vector<std::vector<uint8_t> > transactions;
+      uint32_t transactions_begun;
+
+      // the modelled chain, a byte shifted in at the end pushes the first byte out on CIPO
+      std::vector<uint8_t> chain;
+
+    private:
+      bool in_transaction;
+  };
+
+  extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Wire.h - Host Stand-in for the Arduino TwoWire Library, records every transaction
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+  #include <Arduino.h>
+  #include <deque>
+  #include <vector>
+
+  class TwoWire {
+    public:
+      /*! @struct A completed write transaction and the result returned for it */
+      struct transaction_t {
+        uint8_t address;
+        std::vector<uint8_t> data;
+        uint8_t result;
+      };
+
+      void    begin(void) { }
+      void    beginTransmission(uint8_t address);
+      uint8_t endTransmission(bool stop = true);
+      size_t  write(uint8_t value);
+      size_t  write(const uint8_t *data, size_t size);
+      uint8_t requestFrom(uint8_t address, uint8_t quantity);
+      int     available(void);
+      int     read(void);
+
+      /*! @brief  Forget every transaction and queued result or read byte */
+      void    reset(void);
+
+      // completed write transactions, in order
+      std::vector<transaction_t> transactions;
+
+      // results returned by the next endTransmission() calls, 0 (success) once empty
+      std::deque<uint8_t> results;
+
+      // bytes returned by read() after requestFrom()
+      std::deque<uint8_t> receive;
+
+    private:
+      transaction_t current;
+      uint8_t       requested;
+  };
+
+  extern TwoWire Wire;
+
+#endif
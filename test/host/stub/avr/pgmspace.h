@@ -0,0 +1,31 @@
+/*
+ * pgmspace.h - Host Stand-in for the AVR Program Memory Interface
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_PGMSPACE_H
+#define HOST_PGMSPACE_H
+
+  #include <stdint.h>
+  #include <string.h>
+
+  // the host has a single address space, so program memory is ordinary read-only data
+  #define PROGMEM
+  #define pgm_read_byte(address) (*(const uint8_t  *)(address))
+  #define pgm_read_word(address) (*(const uint16_t *)(address))
+  #define memcpy_P(destination, source, size) memcpy((destination), (source), (size))
+
+#endif
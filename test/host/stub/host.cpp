@@ -0,0 +1,253 @@
+/*
+ * host.cpp - Host Arduino Core, TwoWire and SPI Models for the Host Tests
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include "host.h"
+
+namespace Host {
+  uint32_t clock_micros = 0;
+  uint32_t micros_call_cost = 1;
+  uint32_t analog_read_micros = 112;
+
+  uint8_t  pin_level[HOST_PIN_COUNT];
+  bool     pin_pwm[HOST_PIN_COUNT];
+  uint32_t digital_writes = 0;
+  uint32_t port_accesses = 0;
+
+  std::vector<pin_event_t>    pin_events;
+  std::vector<analog_event_t> analog_events;
+
+  uint16_t analog_level = 0;
+  uint16_t (*analog_source)(uint8_t pin, uint32_t micros) = nullptr;
+
+#if defined(__AVR_ATmega328P__)
+  // PIND, PORTD, PINB, PORTB, PINC, PORTC
+  volatile uint8_t port_registers[6];
+
+  volatile uint8_t &portAccess(const uint8_t index) {
+    port_accesses++;
+    return port_registers[index];
+  }
+
+  // PORTx register and bit of a pin, PORTD = D0-D7, PORTB = D8-D13, PORTC = A0-A5
+  static volatile uint8_t &pinPort(const uint8_t pin) {
+    return port_registers[(pin < 8) ? 1 : ((pin < 14) ? 3 : 5)];
+  }
+
+  static uint8_t pinMask(const uint8_t pin) {
+    return (pin < 8) ? (1 << pin) : ((pin < 14) ? (1 << (pin - 8)) : (1 << (pin - 14)));
+  }
+#endif
+
+  void reset(void) {
+    clock_micros = 0;
+    micros_call_cost = 1;
+    analog_read_micros = 112;
+    memset(pin_level, LOW, sizeof(pin_level));
+    memset(pin_pwm, 0, sizeof(pin_pwm));
+    digital_writes = 0;
+    port_accesses = 0;
+    pin_events.clear();
+    analog_events.clear();
+    analog_level = 0;
+    analog_source = nullptr;
+#if defined(__AVR_ATmega328P__)
+    memset((void *)port_registers, 0, sizeof(port_registers));
+#endif
+    Wire.reset();
+    SPI.reset();
+  }
+
+  void advanceMicros(uint32_t us) {
+    clock_micros += us;
+  }
+}
+
+/**************************************************************************/
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+// like the AVR core, a digital write also disconnects any PWM output from the pin
+void digitalWrite(uint8_t pin, uint8_t value) {
+  Host::digital_writes++;
+  if (pin >= HOST_PIN_COUNT) {
+    return;
+  }
+  Host::pin_pwm[pin] = false;
+  Host::pin_level[pin] = (value != LOW) ? HIGH : LOW;
+  Host::pin_events.push_back(Host::pin_event_t { Host::clock_micros, pin, Host::pin_level[pin] });
+#if defined(__AVR_ATmega328P__)
+  if (value != LOW) {
+    Host::pinPort(pin) |= Host::pinMask(pin);
+  }
+  else {
+    Host::pinPort(pin) &= (uint8_t)~Host::pinMask(pin);
+  }
+#endif
+}
+
+int digitalRead(uint8_t pin) {
+#if defined(__AVR_ATmega328P__)
+  return (Host::pinPort(pin) & Host::pinMask(pin)) ? HIGH : LOW;
+#else
+  return (pin < HOST_PIN_COUNT) ? Host::pin_level[pin] : LOW;
+#endif
+}
+
+int analogRead(uint8_t pin) {
+  Host::analog_events.push_back(Host::analog_event_t { Host::clock_micros, pin });
+  uint16_t level = (Host::analog_source != nullptr) ? 
+                   Host::analog_source(pin, Host::clock_micros) : Host::analog_level;
+  Host::clock_micros += Host::analog_read_micros;
+  return level;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  if (pin < HOST_PIN_COUNT) {
+    Host::pin_pwm[pin] = true;
+    Host::pin_level[pin] = (value > 127) ? HIGH : LOW;
+  }
+}
+
+unsigned long micros(void) {
+  uint32_t now = Host::clock_micros;
+  Host::clock_micros += Host::micros_call_cost;
+  return now;
+}
+
+unsigned long millis(void) {
+  return Host::clock_micros / 1000UL;
+}
+
+void delay(unsigned long ms) {
+  Host::clock_micros += ms * 1000UL;
+}
+
+void delayMicroseconds(unsigned int us) {
+  Host::clock_micros += us;
+}
+
+/**************************************************************************/
+
+TwoWire Wire;
+
+void TwoWire::beginTransmission(uint8_t address) {
+  current.address = address;
+  current.data.clear();
+}
+
+uint8_t TwoWire::endTransmission(bool stop) {
+  (void)stop;
+  current.result = 0;
+  if (!results.empty()) {
+    current.result = results.front();
+    results.pop_front();
+  }
+  transactions.push_back(current);
+  return current.result;
+}
+
+size_t TwoWire::write(uint8_t value) {
+  current.data.push_back(value);
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size) {
+  current.data.insert(current.data.end(), data, data + size);
+  return size;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+  (void)address;
+  requested = (quantity < receive.size()) ? quantity : (uint8_t)receive.size();
+  return requested;
+}
+
+int TwoWire::available(void) {
+  return requested;
+}
+
+int TwoWire::read(void) {
+  if ((requested == 0) || receive.empty()) {
+    return -1;
+  }
+  requested--;
+  uint8_t value = receive.front();
+  receive.pop_front();
+  return value;
+}
+
+void TwoWire::reset(void) {
+  transactions.clear();
+  results.clear();
+  receive.clear();
+  current.data.clear();
+  requested = 0;
+}
+
+/**************************************************************************/
+
+SPIClass SPI;
+
+void SPIClass::beginTransaction(SPISettings settings) {
+  (void)settings;
+  transactions.push_back(std::vector<uint8_t>());
+  transactions_begun++;
+  in_transaction = true;
+}
+
+void SPIClass::endTransaction(void) {
+  in_transaction = false;
+}
+
+uint8_t SPIClass::transfer(uint8_t value) {
+  if (!in_transaction) {
+    transactions.push_back(std::vector<uint8_t>());
+  }
+  transactions.back().push_back(value);
+  if (chain.empty()) {
+    return 0xFF;
+  }
+  uint8_t shifted_out = chain.front();
+  chain.erase(chain.begin());
+  chain.push_back(value);
+  return shifted_out;
+}
+
+void SPIClass::transfer(void *buffer, size_t size) {
+  uint8_t *bytes = static_cast<uint8_t *>(buffer);
+  for (size_t k = 0; k < size; k++) {
+    bytes[k] = this->transfer(bytes[k]);
+  }
+}
+
+void SPIClass::setChain(size_t length, uint8_t fill) {
+  chain.assign(length, fill);
+}
+
+void SPIClass::reset(void) {
+  transactions.clear();
+  transactions_begun = 0;
+  chain.clear();
+  in_transaction = false;
+}
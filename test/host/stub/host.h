@@ -0,0 +1,65 @@
+/*
+ * host.h - Clock, Pin and ADC Model behind the Host Arduino Core
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_MODEL_H
+#define HOST_MODEL_H
+
+  #include <Arduino.h>
+  #include <vector>
+
+  namespace Host {
+    /*! @struct A digital output change, with the fake clock time it happened at */
+    struct pin_event_t {
+      uint32_t micros;
+      uint8_t  pin;
+      uint8_t  value;
+    };
+
+    /*! @struct An analogRead() call, with the fake clock time the conversion started at */
+    struct analog_event_t {
+      uint32_t micros;
+      uint8_t  pin;
+    };
+
+    // fake clock, advanced by delays, by analogRead() and by every micros() call
+    extern uint32_t clock_micros;
+    extern uint32_t micros_call_cost;
+    extern uint32_t analog_read_micros;
+
+    // pin state, whether analogWrite() left PWM running on a pin, and call counts
+    extern uint8_t  pin_level[HOST_PIN_COUNT];
+    extern bool     pin_pwm[HOST_PIN_COUNT];
+    extern uint32_t digital_writes;
+    extern uint32_t port_accesses;
+
+    // every digital output change and analogRead() call, in order
+    extern std::vector<pin_event_t>    pin_events;
+    extern std::vector<analog_event_t> analog_events;
+
+    // level returned by analogRead(), or a function of the pin and time if set
+    extern uint16_t analog_level;
+    extern uint16_t (*analog_source)(uint8_t pin, uint32_t micros);
+
+    /*! @brief  Reset the clock, pins, ADC, TwoWire and SPI models */
+    void reset(void);
+
+    /*! @brief  Advance the fake clock */
+    void advanceMicros(uint32_t us);
+  }
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * test_autovolume_trace.cpp - AutoVolume Replay of a Level Trace
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "host_test.h"
+#include "../../src/audio/AutoVolume.h"
+
+HOST_TEST_MAIN();
+
+#define AMPLIFIER_ADDRESS  (0x4B)
+#define USER_VOLUME        (32U)
+#define BASE_LEVEL         (1500U)
+#define ZERO_SIGNAL_LEVEL  (100U)
+
+// frames per second of the replayed trace, and frames per section of the trace
+#define FRAME_RATE         (100U)
+#define SECTION_FRAMES     (1000U)
+
+struct section_t {
+  uint16_t level;
+  uint16_t noise;
+};
+
+// a minute of sections: the base level, loud and quiet passages, and silence
+static const section_t trace[] = {
+  { 1500, 150 }, { 4000, 400 }, { 1500, 150 }, { 700, 70 }, { 4000, 400 }, { 80, 8 }
+};
+#define TRACE_SECTIONS (sizeof(trace) / sizeof(trace[0]))
+
+static uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// a frame with every band at `level` plus up to `noise` of uniform noise
+static void makeFrame(uint16_t frame[MSGEQ7_BAND_COUNT], const section_t &section, uint32_t &state) {
+  for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+    frame[k] = section.level + (nextRandom(state) % (section.noise + 1));
+  }
+}
+
+// setting the volume writes the centre of the map once, an out of range volume writes nothing
+static void testSetVolume(void) {
+  Host::reset();
+  MAX9744::MAX9744 amp(AMPLIFIER_ADDRESS, 2, 3, &Wire);
+  AutoVolume::AutoVolume engine(amp, ZERO_SIGNAL_LEVEL);
+
+  CHECK(engine.setVolume(USER_VOLUME, BASE_LEVEL));
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+  CHECK_EQUAL(engine.writes(), 1);
+  CHECK_EQUAL(Wire.transactions[0].address, AMPLIFIER_ADDRESS);
+  CHECK_BYTES(Wire.transactions[0].data, { USER_VOLUME });
+  CHECK_EQUAL(engine.volume(), USER_VOLUME);
+
+  // the same volume again is already on the amplifier
+  CHECK(engine.setVolume(USER_VOLUME, BASE_LEVEL));
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+
+  CHECK(!engine.setVolume(MAX9744_MAXIMUM_VOL_LEVEL + 1, BASE_LEVEL));
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+  CHECK_EQUAL(engine.volume(), USER_VOLUME);
+
+  // a frame of the wrong size is ignored
+  uint16_t short_frame[MSGEQ7_BAND_COUNT - 1] = { 0 };
+  CHECK(!engine.update(short_frame, sizeof(short_frame)));
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+}
+
+/*! @brief  Replay the trace and check the amplifier is only written when the volume changes
+*
+* @details Each section reports its writes, the time until the last of them (the settling
+*          time), and the volume it settled at. Louder sections must settle below the user
+*          volume, quieter ones above it, and silence must leave the volume where it was.
+*          The level buffer attacks halfway per slot update but only decays by ~3%, so a
+*          rising level settles within a second and a falling level takes several seconds.
+*/
+static void testTrace(void) {
+  Host::reset();
+  MAX9744::MAX9744 amp(AMPLIFIER_ADDRESS, 2, 3, &Wire);
+  AutoVolume::AutoVolume engine(amp, ZERO_SIGNAL_LEVEL);
+  engine.setVolume(USER_VOLUME, BASE_LEVEL);
+
+  uint32_t state = 0x2545F491UL;
+  uint32_t redundant_writes = 0;
+  uint32_t mismatched_returns = 0;
+  uint32_t settle_millis[TRACE_SECTIONS];
+  uint8_t  settled[TRACE_SECTIONS];
+  for (uint8_t s = 0; s < TRACE_SECTIONS; s++) {
+    uint32_t section_writes = 0;
+    uint32_t last_write = 0;
+    for (uint32_t f = 0; f < SECTION_FRAMES; f++) {
+      uint16_t frame[MSGEQ7_BAND_COUNT];
+      makeFrame(frame, trace[s], state);
+      size_t transactions = Wire.transactions.size();
+      uint8_t previous = engine.volume();
+      bool written = engine.update(frame, sizeof(frame));
+
+      if (written != (Wire.transactions.size() != transactions)) {
+        mismatched_returns++;
+      }
+      if (written) {
+        section_writes++;
+        last_write = f + 1;
+        if (Wire.transactions.back().data[0] == previous) {
+          redundant_writes++;
+        }
+      }
+    }
+    settled[s] = engine.volume();
+    settle_millis[s] = (last_write * 1000U) / FRAME_RATE;
+    printf("  level %4u: %2u writes, settled after %4u ms at volume %u\n", trace[s].level, 
+           section_writes, settle_millis[s], settled[s]);
+  }
+
+  // one bus transaction per counted write, each a single volume byte that changed the volume
+  CHECK_EQUAL(Wire.transactions.size(), engine.writes());
+  CHECK_EQUAL(mismatched_returns, 0);
+  CHECK_EQUAL(redundant_writes, 0);
+  for (size_t k = 0; k < Wire.transactions.size(); k++) {
+    CHECK(Wire.transactions[k].data.size() == 1);
+  }
+  CHECK_EQUAL(Wire.transactions.back().data[0], engine.volume());
+
+  // rising levels settle within a second, and no section is still changing at its end
+  CHECK(settle_millis[1] <= 1000U);
+  CHECK(settle_millis[4] <= 1000U);
+  for (uint8_t s = 0; s < TRACE_SECTIONS; s++) {
+    CHECK(settle_millis[s] < ((SECTION_FRAMES * 1000U) / FRAME_RATE));
+  }
+
+  CHECK(settled[0] == USER_VOLUME);
+  CHECK(settled[1] < USER_VOLUME);
+  CHECK(settled[2] > settled[1]);
+  CHECK(settled[3] > settled[2]);
+  CHECK(settled[4] < settled[3]);
+  CHECK(settled[5] == settled[4]);
+
+  uint32_t seconds = (TRACE_SECTIONS * SECTION_FRAMES) / FRAME_RATE;
+  printf("  %u writes in %u s, %.1f writes per minute\n", engine.writes(), seconds, 
+         (engine.writes() * 60.0) / seconds);
+}
+
+int main(void) {
+  testSetVolume();
+  testTrace();
+  return HostTest::finish("test_autovolume_trace");
+}
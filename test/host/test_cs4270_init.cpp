@@ -0,0 +1,166 @@
+/*
+ * test_cs4270_init.cpp - CS4270 Register Writes on a Fake TwoWire Bus
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "host_test.h"
+#include "../../src/audio/CS4270.h"
+
+HOST_TEST_MAIN();
+
+#define RESET_PIN (4U)
+
+// registers 0x00 to 0x08 of a device receiving the transactions
+struct device_t {
+  uint8_t value[CS4270_DAC_VOLB + 1];
+};
+
+// apply acknowledged write transactions to a device, following the MAP auto-increment bit
+static device_t replay(const std::vector<TwoWire::transaction_t> &transactions) {
+  device_t device = {{ 0 }};
+  for (size_t k = 0; k < transactions.size(); k++) {
+    const TwoWire::transaction_t &transaction = transactions[k];
+    if ((transaction.result != 0) || transaction.data.empty()) {
+      continue;
+    }
+    uint8_t address = transaction.data[0] & (uint8_t)~CS4270_MAP_INCR;
+    bool increment = (transaction.data[0] & CS4270_MAP_INCR) != 0;
+    for (size_t n = 1; n < transaction.data.size(); n++) {
+      device.value[address] = transaction.data[n];
+      if (increment) {
+        address++;
+      }
+    }
+  }
+  return device;
+}
+
+// the eight single-register writes of the original init(), for the default configuration
+static std::vector<TwoWire::transaction_t> originalInit(void) {
+  static const uint8_t writes[8][2] = {
+    { CS4270_PWR_CTRL, 0x01 }, { CS4270_MDE_CTRL, 0x01 }, { CS4270_ADDACTRL, 0x29 },
+    { CS4270_TRN_CTRL, 0xF0 }, { CS4270_MTE_CTRL, 0x00 }, { CS4270_DAC_VOLA, 0x00 },
+    { CS4270_DAC_VOLB, 0x00 }, { CS4270_PWR_CTRL, 0x00 }
+  };
+  std::vector<TwoWire::transaction_t> transactions;
+  for (uint8_t k = 0; k < 8; k++) {
+    TwoWire::transaction_t transaction = { CS4270_DEFAULT_I2CADDR, { writes[k][0], writes[k][1] }, 0 };
+    transactions.push_back(transaction);
+  }
+  return transactions;
+}
+
+// init() is one burst with PDN set and one write clearing it, leaving the original register state
+static void testInitBytes(void) {
+  Host::reset();
+  CS4270::CS4270 codec(CS4270_DEFAULT_I2CADDR, RESET_PIN, &Wire);
+  CHECK(codec.init());
+
+  CHECK_EQUAL(Wire.transactions.size(), 2);
+  CHECK_EQUAL(Wire.transactions[0].address, CS4270_DEFAULT_I2CADDR);
+  CHECK_BYTES(Wire.transactions[0].data, { 0x82, 0x01, 0x01, 0x29, 0xF0, 0x00, 0x00, 0x00 });
+  CHECK_EQUAL(Wire.transactions[1].address, CS4270_DEFAULT_I2CADDR);
+  CHECK_BYTES(Wire.transactions[1].data, { 0x82, 0x00 });
+
+  device_t burst = replay(Wire.transactions);
+  device_t original = replay(originalInit());
+  CHECK_EQUAL(memcmp(burst.value, original.value, sizeof(burst.value)), 0);
+
+  // the reset line ends low, as it was left by the original init()
+  CHECK_EQUAL(Host::pin_level[RESET_PIN], LOW);
+}
+
+// each configuration option sets its own register bits in the burst
+static void testInitConfig(void) {
+  Host::reset();
+  const CS4270::CS4270Types::config_t config = { false, true, true };
+  CS4270::CS4270 codec(CS4270_DEFAULT_I2CADDR, RESET_PIN, &Wire, config);
+  CHECK(codec.init());
+  CHECK_EQUAL(Wire.transactions.size(), 2);
+  CHECK_BYTES(Wire.transactions[0].data, { 0x82, 0x01, 0x01, 0x09, 0xF1, 0x20, 0x00, 0x00 });
+  CHECK_BYTES(Wire.transactions[1].data, { 0x82, 0x00 });
+}
+
+// an unacknowledged address fails init() after one transaction, and a retry writes it all again
+static void testInitNack(void) {
+  Host::reset();
+  CS4270::CS4270 codec(CS4270_DEFAULT_I2CADDR, RESET_PIN, &Wire);
+  Wire.results.push_back(CS4270::CS4270Types::NACK_ADDRESS);
+  CHECK(!codec.init());
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+
+  Wire.transactions.clear();
+  CHECK(codec.init());
+  CHECK_EQUAL(Wire.transactions.size(), 2);
+  CHECK_BYTES(Wire.transactions[0].data, { 0x82, 0x01, 0x01, 0x29, 0xF0, 0x00, 0x00, 0x00 });
+  CHECK_BYTES(Wire.transactions[1].data, { 0x82, 0x00 });
+}
+
+// a failed write stays dirty, so the next burst starts from it
+static void testDirtyRetry(void) {
+  Host::reset();
+  CS4270::CS4270 codec(CS4270_DEFAULT_I2CADDR, RESET_PIN, &Wire);
+  Wire.results.push_back(CS4270::CS4270Types::NO_ERROR);
+  Wire.results.push_back(CS4270::CS4270Types::NACK_DATA);
+  CHECK(codec.init());
+  CHECK_EQUAL(Wire.transactions.size(), 2);
+
+  Wire.transactions.clear();
+  codec.mute();
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+  CHECK_BYTES(Wire.transactions[0].data, { 0x82, 0x00, 0x01, 0x29, 0xF0, 0x1A });
+}
+
+// later writes only send the registers that changed
+static void testChangedRegisters(void) {
+  Host::reset();
+  CS4270::CS4270 codec(CS4270_DEFAULT_I2CADDR, RESET_PIN, &Wire);
+  codec.init();
+  Wire.transactions.clear();
+
+  codec.volume(20, CS4270::CS4270::Stereo);
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+  CHECK_BYTES(Wire.transactions[0].data, { 0x87, 20, 20 });
+
+  codec.volume(20, CS4270::CS4270::Mono_ChA);
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+
+  codec.volume(CS4270_MAXIMUM_ATTENUATION + 1, CS4270::CS4270::Stereo);
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+
+  codec.mute();
+  CHECK_EQUAL(Wire.transactions.size(), 2);
+  CHECK_BYTES(Wire.transactions[1].data, { 0x86, 0x1A });
+  CHECK(codec.isMuted());
+
+  // auto-mute keeps the mute bits
+  const CS4270::CS4270Types::config_t config = { true, false, true };
+  CHECK(codec.configure(config));
+  CHECK_EQUAL(Wire.transactions.size(), 3);
+  CHECK_BYTES(Wire.transactions[2].data, { 0x86, 0x3A });
+
+  CHECK(codec.configure(config));
+  CHECK_EQUAL(Wire.transactions.size(), 3);
+}
+
+int main(void) {
+  testInitBytes();
+  testInitConfig();
+  testInitNack();
+  testDirtyRetry();
+  testChangedRegisters();
+  return HostTest::finish("test_cs4270_init");
+}
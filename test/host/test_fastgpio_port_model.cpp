@@ -0,0 +1,186 @@
+/*
+ * test_fastgpio_port_model.cpp - Compile-time Pin Variants on an ATmega328P Port Model
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// built with __AVR_ATmega328P__ defined, so FastGPIO uses the port map and every
+// PORTx/PINx access goes through the counted port model in stub/host.cpp
+#include "host_test.h"
+#include "../../src/io/buttonled.h"
+#include "../../src/audio/MSGEQ7.h"
+
+HOST_TEST_MAIN();
+
+// modelled cost of digitalWrite() on an ATmega328P with the stock core (pin table
+// lookups, PWM timer check, SREG save/restore), and of a single sbi/cbi port write
+#define DIGITALWRITE_CYCLES (60U)
+#define PORT_WRITE_CYCLES   ( 2U)
+
+#define LED_PIN     (13U)   // PORTB bit 5
+#define BUTTON_PIN  ( 8U)   // PORTB bit 0
+#define STROBE_PIN  ( 4U)   // PORTD bit 4
+#define RESET_PIN   ( 5U)   // PORTD bit 5
+#define DC_OUT_PIN  (A0)
+
+enum port_register_t { REG_PIND = 0, REG_PORTD, REG_PINB, REG_PORTB, REG_PINC, REG_PORTC };
+
+static uint32_t modelCycles(const uint32_t digital_writes, const uint32_t port_accesses) {
+  return (digital_writes * DIGITALWRITE_CYCLES) + (port_accesses * PORT_WRITE_CYCLES);
+}
+
+// each Pin operation is one access of the right port register and bit
+static void testPinMapping(void) {
+  Host::reset();
+  typedef FastGPIO::Pin<LED_PIN> led;
+
+  led::high();
+  CHECK_EQUAL(Host::port_registers[REG_PORTB], 1U << 5);
+  led::low();
+  CHECK_EQUAL(Host::port_registers[REG_PORTB], 0);
+  CHECK_EQUAL(Host::port_accesses, 2);
+
+  // toggling writes the pin bit to PINx, which flips PORTx on the AVR
+  led::toggle();
+  CHECK_EQUAL(Host::port_registers[REG_PINB], 1U << 5);
+  CHECK_EQUAL(Host::port_accesses, 3);
+
+  FastGPIO::Pin<2>::high();
+  CHECK_EQUAL(Host::port_registers[REG_PORTD], 1U << 2);
+  FastGPIO::Pin<A0 + 3>::high();
+  CHECK_EQUAL(Host::port_registers[REG_PORTC], 1U << 3);
+
+  Host::port_registers[REG_PINB] = 1U << 0;
+  ButtonLED::ButtonPin<BUTTON_PIN> button;
+  CHECK(button.read());
+  Host::port_registers[REG_PINB] = 0;
+  CHECK(!button.read());
+  CHECK_EQUAL(Host::digital_writes, 0);
+}
+
+// on/off of the compile-time LED costs a port write instead of a digitalWrite()
+static void testLEDCycles(void) {
+  Host::reset();
+  ButtonLED::LED runtime_led(LED_PIN);
+  runtime_led.init();
+  Host::digital_writes = 0;
+  for (uint8_t k = 0; k < 50; k++) {
+    runtime_led.on();
+    runtime_led.off();
+  }
+  uint32_t runtime_cycles = modelCycles(Host::digital_writes, Host::port_accesses);
+  CHECK_EQUAL(Host::digital_writes, 100);
+
+  Host::reset();
+  ButtonLED::LEDPin<LED_PIN> led;
+  led.init();
+  Host::digital_writes = 0;
+  Host::port_accesses = 0;
+  for (uint8_t k = 0; k < 50; k++) {
+    led.on();
+    CHECK_EQUAL(Host::port_registers[REG_PORTB], 1U << 5);
+    led.off();
+    CHECK_EQUAL(Host::port_registers[REG_PORTB], 0);
+  }
+  uint32_t pin_cycles = modelCycles(Host::digital_writes, Host::port_accesses);
+  CHECK_EQUAL(Host::digital_writes, 0);
+  CHECK_EQUAL(Host::port_accesses, 100);
+
+  printf("  100 LED writes: LED %u cycles, LEDPin %u cycles (modelled)\n", runtime_cycles, pin_cycles);
+  CHECK(pin_cycles * 20 <= runtime_cycles);
+}
+
+// after brightness() the next write goes through digitalWrite() to disconnect PWM
+static void testLEDPinStopsPWM(void) {
+  Host::reset();
+  ButtonLED::LEDPin<LED_PIN> led;
+  led.init();
+  CHECK_EQUAL(Host::digital_writes, 1);
+
+  led.brightness(128);
+  CHECK(Host::pin_pwm[LED_PIN]);
+  led.on();
+  CHECK(!Host::pin_pwm[LED_PIN]);
+  CHECK_EQUAL(Host::digital_writes, 2);
+  CHECK_EQUAL(Host::port_registers[REG_PORTB], 1U << 5);
+
+  // PWM is off, so the following writes are port writes again
+  led.off();
+  led.on();
+  CHECK_EQUAL(Host::digital_writes, 2);
+  CHECK_EQUAL(Host::port_registers[REG_PORTB], 1U << 5);
+
+  led.brightness(10);
+  led.off();
+  CHECK(!Host::pin_pwm[LED_PIN]);
+  CHECK_EQUAL(Host::digital_writes, 3);
+  CHECK_EQUAL(Host::port_registers[REG_PORTB], 0);
+}
+
+// STROBE must be low while each band is sampled
+static uint32_t strobe_low_samples;
+
+static uint16_t sampleStrobe(uint8_t pin, uint32_t micros) {
+  (void)pin;
+  (void)micros;
+  bool strobe_low = !(Host::port_registers[REG_PORTD] & (1U << (STROBE_PIN & 0x07)));
+  bool reset_low = !(Host::port_registers[REG_PORTD] & (1U << (RESET_PIN & 0x07)));
+  strobe_low_samples += (strobe_low && reset_low) ? 1 : 0;
+  return 512;
+}
+
+// the compile-time MSGEQ7 sequence drives the same edges with port writes only
+static void testMSGEQ7Cycles(void) {
+  Host::reset();
+  Host::analog_source = &sampleStrobe;
+  uint16_t levels[MSGEQ7_BAND_COUNT];
+
+  MSGEQ7::MSGEQ7 runtime_eq(STROBE_PIN, DC_OUT_PIN, RESET_PIN, false);
+  runtime_eq.init();
+  Host::digital_writes = 0;
+  strobe_low_samples = 0;
+  runtime_eq.read(levels, sizeof(levels));
+  uint32_t runtime_writes = Host::digital_writes;
+  uint32_t runtime_cycles = modelCycles(Host::digital_writes, Host::port_accesses);
+  CHECK_EQUAL(strobe_low_samples, MSGEQ7_BAND_COUNT);
+
+  Host::reset();
+  Host::analog_source = &sampleStrobe;
+  MSGEQ7::MSGEQ7Pins<STROBE_PIN, DC_OUT_PIN, RESET_PIN> eq(false);
+  eq.init();
+  Host::digital_writes = 0;
+  Host::port_accesses = 0;
+  strobe_low_samples = 0;
+  eq.read(levels, sizeof(levels));
+  uint32_t pin_cycles = modelCycles(Host::digital_writes, Host::port_accesses);
+  CHECK_EQUAL(strobe_low_samples, MSGEQ7_BAND_COUNT);
+  CHECK_EQUAL(Host::digital_writes, 0);
+  CHECK_EQUAL(Host::port_accesses, runtime_writes);
+
+  // both leave STROBE and RESET high, in standby
+  CHECK_EQUAL(Host::port_registers[REG_PORTD] & 0x30, 0x30);
+
+  printf("  MSGEQ7 frame edges: MSGEQ7 %u cycles, MSGEQ7Pins %u cycles (modelled)\n", 
+         runtime_cycles, pin_cycles);
+  CHECK(pin_cycles * 20 <= runtime_cycles);
+}
+
+int main(void) {
+  testPinMapping();
+  testLEDCycles();
+  testLEDPinStopsPWM();
+  testMSGEQ7Cycles();
+  return HostTest::finish("test_fastgpio_port_model");
+}
@@ -0,0 +1,157 @@
+/*
+ * test_max9744_level_index.cpp - MAX9744 log2 Level Estimator against the Threshold Scan
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include "host_test.h"
+#include "../../src/audio/MAX9744.h"
+
+HOST_TEST_MAIN();
+
+#define BASE_LEVEL_MAXIMUM (4000U)
+
+// levels that drive the volume map index to either end of the map
+#define LEVEL_BOTTOM       (0U)
+#define LEVEL_TOP          (65535U)
+
+// enough calls for the index to cross the whole map one step at a time
+#define INDEX_CALLS        (DB_FAST_COEFFICIENT_COUNT + 2)
+
+/*! @brief  The volume map index of a level before hysteresis
+*
+* @details The hysteresis only steps the index towards the level's index until it is within
+*          one of it, except at the ends of the map where it jumps. So the index is driven to
+*          the bottom of the map and then held at the level (settling one below its index),
+*          then driven to the top and held at the level (settling one above), and the index
+*          is between the two.
+*/
+template <typename index_t>
+static int8_t rawIndex(index_t index, const uint16_t level) {
+  for (uint8_t k = 0; k < INDEX_CALLS; k++) { index(LEVEL_BOTTOM); }
+  int8_t below = 0;
+  for (uint8_t k = 0; k < INDEX_CALLS; k++) { below = index(level); }
+  for (uint8_t k = 0; k < INDEX_CALLS; k++) { index(LEVEL_TOP); }
+  int8_t above = 0;
+  for (uint8_t k = 0; k < INDEX_CALLS; k++) { above = index(level); }
+
+  if (below == 0 && above <= 1) {
+    return 0;
+  }
+  if (above == (DB_FAST_COEFFICIENT_COUNT - 1) && below >= (DB_FAST_COEFFICIENT_COUNT - 2)) {
+    return DB_FAST_COEFFICIENT_COUNT - 1;
+  }
+  return (below + above) >> 1;
+}
+
+// the estimator is within a few milliBels of 2000 * log10(level)
+static void testLevelToMilliBels(MAX9744::MAX9744 &amp) {
+  double worst = 0;
+  for (uint32_t level = 2; level <= 65535; level++) {
+    double error = fabs(amp.levelToMilliBels(level) - (2000.0 * log10((double)level)));
+    worst = (error > worst) ? error : worst;
+  }
+  printf("  levelToMilliBels(): worst error %.1f milliBels\n", worst);
+  CHECK(worst < 5.0);
+  CHECK_EQUAL(amp.levelToMilliBels(0), 0);
+  CHECK_EQUAL(amp.levelToMilliBels(1), 0);
+}
+
+/*! @brief  Sweep base levels and the levels around each threshold
+*
+* @details Every base level from 1 to BASE_LEVEL_MAXIMUM, at base / 3, 3 * base, and one
+*          under, at and over each of its thresholds, which is where the two can disagree.
+*          Below LOG2_MINIMUM_BASE_LEVEL the indexes must match, and above it they must be
+*          within one.
+*/
+static void testIndexesAgree(MAX9744::MAX9744 &amp) {
+  uint32_t levels = 0;
+  uint32_t small_base_mismatches = 0;
+  uint32_t off_by_one = 0;
+  uint32_t off_by_more = 0;
+  uint16_t dB_levels[DB_FAST_COEFFICIENT_COUNT];
+  std::vector<uint16_t> sweep;
+
+  // the base level is the middle of the map, and the bounds are the ends
+  amp.dBFastRelativeLevel(dB_levels, 1500);
+  amp.setRelativeBaseLevel(1500);
+  CHECK_EQUAL(rawIndex([&](uint16_t level) { return amp.getVolumeMapIndx(level); }, 1500), 
+              DB_FAST_COEFFICIENT_COUNT >> 1);
+  CHECK_EQUAL(rawIndex([&](uint16_t level) { return amp.getVolumeMapIndx(level); }, 1500 / 3), 0);
+  CHECK_EQUAL(rawIndex([&](uint16_t level) { return amp.getVolumeMapIndx(level); }, 1500 * 3), 
+              DB_FAST_COEFFICIENT_COUNT - 1);
+
+  for (uint16_t base = 1; base <= BASE_LEVEL_MAXIMUM; base++) {
+    amp.dBFastRelativeLevel(dB_levels, base);
+    amp.setRelativeBaseLevel(base);
+
+    sweep.clear();
+    sweep.push_back(base / 3);
+    sweep.push_back(base * 3);
+    for (uint8_t k = 0; k < DB_FAST_COEFFICIENT_COUNT; k++) {
+      if (dB_levels[k] > 0) {
+        sweep.push_back(dB_levels[k] - 1);
+      }
+      sweep.push_back(dB_levels[k]);
+      sweep.push_back(dB_levels[k] + 1);
+    }
+
+    for (size_t s = 0; s < sweep.size(); s++) {
+      int8_t scan = rawIndex([&](uint16_t level) { 
+        return amp.getVolumeMapIndx(level, dB_levels, sizeof(dB_levels)); 
+      }, sweep[s]);
+      int8_t log2 = rawIndex([&](uint16_t level) { 
+        return amp.getVolumeMapIndx(level); 
+      }, sweep[s]);
+      int8_t difference = abs(scan - log2);
+      levels++;
+      if (base < LOG2_MINIMUM_BASE_LEVEL) {
+        small_base_mismatches += (difference != 0) ? 1 : 0;
+      }
+      else {
+        off_by_one += (difference == 1) ? 1 : 0;
+        off_by_more += (difference > 1) ? 1 : 0;
+      }
+    }
+  }
+  printf("  %u levels: %u one index apart, %u further apart\n", levels, off_by_one, off_by_more);
+  CHECK_EQUAL(small_base_mismatches, 0);
+  CHECK_EQUAL(off_by_more, 0);
+}
+
+// host cost of an index, threshold scan against the log2 estimator
+static void benchmark(MAX9744::MAX9744 &amp) {
+  static const uint16_t base = 1500;
+  uint16_t dB_levels[DB_FAST_COEFFICIENT_COUNT];
+  amp.dBFastRelativeLevel(dB_levels, base);
+  amp.setRelativeBaseLevel(base);
+
+  double scan = HostTest::nanosPerCall(1000000UL, [&](uint32_t n) {
+    HOST_KEEP(amp.getVolumeMapIndx((base / 3) + (n & 0x0FFF), dB_levels, sizeof(dB_levels)));
+  });
+  double log2 = HostTest::nanosPerCall(1000000UL, [&](uint32_t n) {
+    HOST_KEEP(amp.getVolumeMapIndx((base / 3) + (n & 0x0FFF)));
+  });
+  printf("  per index: threshold scan %.1f ns, log2 estimator %.1f ns (host)\n", scan, log2);
+}
+
+int main(void) {
+  MAX9744::MAX9744 amp(0x4B, 2, 3, &Wire);
+  testLevelToMilliBels(amp);
+  testIndexesAgree(amp);
+  benchmark(amp);
+  return HostTest::finish("test_max9744_level_index");
+}
@@ -0,0 +1,155 @@
+/*
+ * test_max9744_volume_map.cpp - MAX9744 Volume Maps against the Original Linear Scan
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// built twice, with MAX9744_PRECOMPUTE_VOLUME_MAPS true (PROGMEM table copy) and false
+// (binary search of the gain table)
+#include "host_test.h"
+#include "../../src/audio/MAX9744.h"
+
+HOST_TEST_MAIN();
+
+// MAX9744 amplifier gain levels from the datasheet, in milliBels
+static const int16_t datasheet_gain[64] = 
+{
+  -10950,  -9290,   -9030,   -8680,
+  -8430,   -8080,   -7830,   -7470,
+  -7220,   -6870,   -6620,   -6270,
+  -6020,   -5670,   -5420,   -5060,
+  -4810,   -4560,   -4370,   -4210,
+  -3960,   -3760,   -3600,   -3340,
+  -3150,   -2980,   -2720,   -2520,
+  -2350,   -2160,   -1970,   -1750,
+  -1640,   -1540,   -1440,   -1310,
+  -1200,   -1090,   -990,    -890,
+  -710,    -600,    -500,    -340,
+  -190,    -50,      50,      120,
+  160,     200,     240,     290,
+  340,     390,     440,     490,
+  540,     590,     650,     700,
+  760,     820,     880,     950
+};
+
+// MAX9744::mapVolumeToBoundedRange() before the binary search and PROGMEM tables, a
+// linear scan of the gain table with two variable length arrays
+static void mapVolumeToBoundedRangeLinear(const uint8_t volume, uint8_t *volume_map, 
+                                          const size_t volume_map_size) {
+  if (volume_map_size != (size_t)DB_FAST_COEFFICIENT_COUNT) {
+    return; // volumeMap array isn't sized right so return without doing anything
+  }
+  uint8_t a = MAX9744_MINIMUM_VOL_LEVEL;
+  uint8_t b = MAX9744_MAXIMUM_VOL_LEVEL;
+  int16_t gain_current_volume = datasheet_gain[volume];
+
+  // find the upper and lower bounds for volume values
+  if (volume != 0) {
+    for(int16_t k = volume - 1; k >= 0; k--) {
+      if ((datasheet_gain[k] - gain_current_volume) < MILLIBEL_BOUND_LOWER) {
+        a = k + 1;
+        break;
+      }
+    }
+  }
+  if (volume != MAX9744_MAXIMUM_VOL_LEVEL) {
+    for(uint8_t k = volume + 1; k < MAX9744_MAXIMUM_VOL_LEVEL; k++) {
+      if ((datasheet_gain[k] - gain_current_volume) > MILLIBEL_BOUND_UPPER) {
+        b = k - 1;
+        break;
+      }
+    }
+  }
+
+  uint8_t v_range = (b - a) + 1;
+  uint8_t v[v_range];
+  for (int16_t k = b; k >= (int16_t)a; k--) {
+    v[b - k] = k;
+  }
+
+  int16_t c_normal[v_range];
+  for (uint8_t k = 0; k < v_range; k++) {
+    c_normal[k] = datasheet_gain[v[k]] - gain_current_volume;
+  }
+
+  uint8_t skip_zero_index = 0;
+  uint8_t map_index = 0;
+  for (uint8_t k = 0; k < volume_map_size; k++) {
+    if (c_normal[map_index] == 0) {
+      skip_zero_index = 1;
+    }
+    if ((map_index + skip_zero_index) < v_range) {
+      if ((MILLIBEL_BOUND_UPPER - c_normal[map_index + skip_zero_index]) 
+          < (k * MILLIBEL_STEP_SIZE)) {
+        map_index++;
+      }
+    }
+    volume_map[k] = v[map_index];
+  }
+}
+
+// the amplifier's gain table is the datasheet table
+static void testGainTable(MAX9744::MAX9744 &amp) {
+  int16_t gains[MAX9744_MAXIMUM_VOL_LEVEL + 1];
+  amp.convertVolumeToGain(MAX9744_MINIMUM_VOL_LEVEL, MAX9744_MAXIMUM_VOL_LEVEL, gains, 64);
+  CHECK_EQUAL(memcmp(gains, datasheet_gain, sizeof(gains)), 0);
+}
+
+// every volume gives the same map as the linear scan, byte for byte
+static void testMapsMatch(MAX9744::MAX9744 &amp) {
+  uint32_t mismatches = 0;
+  for (uint8_t volume = MAX9744_MINIMUM_VOL_LEVEL; volume <= MAX9744_MAXIMUM_VOL_LEVEL; volume++) {
+    uint8_t expected[DB_FAST_COEFFICIENT_COUNT];
+    uint8_t actual[DB_FAST_COEFFICIENT_COUNT];
+    memset(actual, 0xEE, sizeof(actual));
+    mapVolumeToBoundedRangeLinear(volume, expected, sizeof(expected));
+    amp.mapVolumeToBoundedRange(volume, actual, sizeof(actual));
+    if (memcmp(expected, actual, sizeof(actual)) != 0) {
+      mismatches++;
+      printf("  volume %u differs\n", volume);
+    }
+  }
+  CHECK_EQUAL(mismatches, 0);
+
+  // a wrongly sized map is left untouched
+  uint8_t short_map[DB_FAST_COEFFICIENT_COUNT - 1];
+  memset(short_map, 0xEE, sizeof(short_map));
+  amp.mapVolumeToBoundedRange(32, short_map, sizeof(short_map));
+  CHECK_EQUAL(short_map[0], 0xEE);
+}
+
+// host cost of building a map, old linear scan against the current build
+static void benchmark(MAX9744::MAX9744 &amp) {
+  static uint8_t volume_map[DB_FAST_COEFFICIENT_COUNT];
+  double linear = HostTest::nanosPerCall(1000000UL, [&](uint32_t n) {
+    mapVolumeToBoundedRangeLinear(n & MAX9744_MAXIMUM_VOL_LEVEL, volume_map, sizeof(volume_map));
+    HOST_KEEP(volume_map[0]);
+  });
+  double current = HostTest::nanosPerCall(1000000UL, [&](uint32_t n) {
+    amp.mapVolumeToBoundedRange(n & MAX9744_MAXIMUM_VOL_LEVEL, volume_map, sizeof(volume_map));
+    HOST_KEEP(volume_map[0]);
+  });
+  printf("  per map: linear scan %.1f ns, %s %.1f ns (host)\n", linear, 
+         MAX9744_PRECOMPUTE_VOLUME_MAPS ? "PROGMEM table" : "binary search", current);
+}
+
+int main(void) {
+  MAX9744::MAX9744 amp(0x4B, 2, 3, &Wire);
+  testGainTable(amp);
+  testMapsMatch(amp);
+  benchmark(amp);
+  return HostTest::finish(MAX9744_PRECOMPUTE_VOLUME_MAPS ? 
+                          "test_max9744_volume_map" : "test_max9744_volume_map_search");
+}
@@ -0,0 +1,115 @@
+/*
+ * test_max9744_volume_writes.cpp - MAX9744 Volume Shadow and Ramps on a Fake TwoWire Bus
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "host_test.h"
+#include "../../src/audio/MAX9744.h"
+
+HOST_TEST_MAIN();
+
+#define AMPLIFIER_ADDRESS (0x4B)
+
+// more ticks than there are volume steps, so any ramp that can finish does
+#define TICKS_MAXIMUM     (2 * (MAX9744_MAXIMUM_VOL_LEVEL + 1))
+
+static int16_t gain[MAX9744_MAXIMUM_VOL_LEVEL + 1];
+
+static void tickFor(MAX9744::MAX9744 &amp, const uint32_t millis_elapsed) {
+  Host::advanceMicros(millis_elapsed * 1000UL);
+  for (uint8_t k = 0; (k < TICKS_MAXIMUM) && amp.tick(); k++) { }
+}
+
+// the shadow skips repeated volumes, and a failed write forgets the device volume
+static void testShadow(void) {
+  Host::reset();
+  MAX9744::MAX9744 amp(AMPLIFIER_ADDRESS, 2, 3, &Wire);
+  CHECK_EQUAL(amp.getVolume(), MAX9744_VOLUME_UNKNOWN);
+
+  amp.volume(20);
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+  CHECK_EQUAL(Wire.transactions[0].address, AMPLIFIER_ADDRESS);
+  CHECK_BYTES(Wire.transactions[0].data, { 20 });
+  CHECK_EQUAL(amp.getVolume(), 20);
+
+  amp.volume(20);
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+  CHECK_EQUAL(amp.getVolumeStats().writes, 1);
+  CHECK_EQUAL(amp.getVolumeStats().writes_skipped, 1);
+
+  // a NACK leaves the volume unknown, so the same volume is written again
+  Wire.results.push_back(MAX9744::MAX9744Types::NACK_DATA);
+  amp.volume(30);
+  CHECK_EQUAL(Wire.transactions.size(), 2);
+  CHECK_EQUAL(amp.getVolume(), MAX9744_VOLUME_UNKNOWN);
+  amp.volume(30);
+  CHECK_EQUAL(Wire.transactions.size(), 3);
+  CHECK_BYTES(Wire.transactions[2].data, { 30 });
+  CHECK_EQUAL(amp.getVolume(), 30);
+
+  amp.volume(MAX9744_MAXIMUM_VOL_LEVEL + 10);
+  CHECK_BYTES(Wire.transactions.back().data, { MAX9744_MAXIMUM_VOL_LEVEL });
+}
+
+// a ramp's total gain change stays within its slew rate, with one write per tick
+static void testRampSlew(void) {
+  Host::reset();
+  MAX9744::MAX9744 amp(AMPLIFIER_ADDRESS, 2, 3, &Wire);
+  amp.volume(10);
+  Wire.transactions.clear();
+
+  amp.ramp(40, 1000);
+  uint32_t seconds = 0;
+  uint32_t too_fast = 0;
+  while (amp.ramping() && (seconds < 20)) {
+    size_t transactions = Wire.transactions.size();
+    Host::advanceMicros(1000000UL);
+    amp.tick();
+    seconds++;
+    CHECK(Wire.transactions.size() <= (transactions + 1));
+    if ((gain[amp.getVolume()] - gain[10]) > (int32_t)(seconds * 1000UL)) {
+      too_fast++;
+    }
+  }
+  CHECK_EQUAL(too_fast, 0);
+  CHECK_EQUAL(amp.getVolume(), 40);
+
+  // 5910 milliBels at 1000 milliBels per second
+  CHECK(seconds >= 6);
+  CHECK(seconds <= 7);
+}
+
+// a long gap between ticks finishes the ramp instead of overflowing the gain budget
+static void testRampGap(const uint16_t slew_milliBels, const uint32_t gap_millis) {
+  Host::reset();
+  MAX9744::MAX9744 amp(AMPLIFIER_ADDRESS, 2, 3, &Wire);
+  amp.volume(10);
+  amp.ramp(40, slew_milliBels);
+  tickFor(amp, gap_millis);
+  CHECK_EQUAL(amp.getVolume(), 40);
+  CHECK(!amp.ramping());
+}
+
+int main(void) {
+  MAX9744::MAX9744 amp(AMPLIFIER_ADDRESS, 2, 3, &Wire);
+  amp.convertVolumeToGain(MAX9744_MINIMUM_VOL_LEVEL, MAX9744_MAXIMUM_VOL_LEVEL, gain, 64);
+
+  testShadow();
+  testRampSlew();
+  testRampGap(65535, 65538UL);
+  testRampGap(6000, 715828UL);
+  return HostTest::finish("test_max9744_volume_writes");
+}
@@ -0,0 +1,207 @@
+/*
+ * test_msgeq7_frame_ring.cpp - MSGEQ7 Frame Ring Interleaving, Drop Accounting and Cost
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "host_test.h"
+#include "../../src/audio/MSGEQ7.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  // x86 keeps stores in program order like the AVR, so the compiler barriers in
+  // FrameRing are enough for a real producer thread
+  #include <thread>
+  #define FRAME_RING_THREAD_TEST (true )
+#else
+  #define FRAME_RING_THREAD_TEST (false)
+#endif
+
+HOST_TEST_MAIN();
+
+using namespace MSGEQ7::MSGEQ7Types;
+
+#define RING_DEPTH (4U)
+
+typedef MSGEQ7::FrameRing<RING_DEPTH> ring_t;
+
+// every band of frame `n` is derived from `n`, so a frame mixing two pushes is detected
+static void makeFrame(uint16_t bands[], const uint16_t n) {
+  for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+    bands[k] = (uint16_t)((n * MSGEQ7_BAND_COUNT) + k);
+  }
+}
+
+static bool torn(const frame_t &frame) {
+  for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+    if (frame.band[k] != (uint16_t)((frame.sequence * MSGEQ7_BAND_COUNT) + k)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// xorshift, so the interleaving is the same on every run
+static uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// a full ring drops new frames, and every frame the consumer never saw is counted
+static void testDropOnFull(void) {
+  ring_t ring;
+  uint16_t bands[MSGEQ7_BAND_COUNT];
+  for (uint16_t n = 1; n <= RING_DEPTH; n++) {
+    makeFrame(bands, n);
+    CHECK(ring.push(bands));
+  }
+  makeFrame(bands, RING_DEPTH + 1);
+  CHECK(!ring.push(bands));
+  makeFrame(bands, RING_DEPTH + 2);
+  CHECK(!ring.push(bands));
+  CHECK_EQUAL(ring.available(), RING_DEPTH);
+
+  // the newest queued frame is the last one pushed before the ring filled
+  frame_t frame;
+  CHECK(ring.popNewest(frame));
+  CHECK_EQUAL(frame.sequence, RING_DEPTH);
+  CHECK(!torn(frame));
+  CHECK_EQUAL(ring.lost(), RING_DEPTH - 1);
+  CHECK_EQUAL(ring.available(), 0);
+
+  // the two dropped frames show up as a sequence gap on the next pop
+  makeFrame(bands, RING_DEPTH + 3);
+  CHECK(ring.push(bands));
+  CHECK(ring.pop(frame));
+  CHECK_EQUAL(frame.sequence, RING_DEPTH + 3);
+  CHECK_EQUAL(ring.lost(), RING_DEPTH + 1);
+  CHECK(!ring.pop(frame));
+}
+
+// a producer and consumer interleaved at random never see a torn or reordered frame
+static void testInterleaved(void) {
+  ring_t ring;
+  uint32_t state = 0x2545F491UL;
+  uint16_t bands[MSGEQ7_BAND_COUNT];
+  uint16_t produced = 0;
+  uint16_t received = 0;
+  uint16_t last = 0;
+
+  // sequence numbers are 16-bit, so stay within one wrap of the counters
+  uint32_t torn_frames = 0;
+  uint32_t reordered = 0;
+
+  for (uint32_t step = 0; step < 100000UL; step++) {
+    uint32_t choice = nextRandom(state) & 0x07;
+    frame_t frame;
+    if (choice < 4) {
+      produced++;
+      makeFrame(bands, produced);
+      ring.push(bands);
+    }
+    else if ((choice < 7) ? ring.pop(frame) : ring.popNewest(frame)) {
+      torn_frames += torn(frame) ? 1 : 0;
+      reordered += ((uint16_t)(frame.sequence - last) == 0) ? 1 : 0;
+      last = frame.sequence;
+      received++;
+    }
+  }
+  CHECK_EQUAL(torn_frames, 0);
+  CHECK_EQUAL(reordered, 0);
+
+  // every produced frame was received, lost or is still queued
+  CHECK_EQUAL((uint16_t)(received + ring.lost() + ring.available()), produced);
+  printf("  interleaved: %u frames produced, %u received, %u lost\n", 
+         produced, received, ring.lost());
+}
+
+#if FRAME_RING_THREAD_TEST
+// a producer thread standing in for the timer interrupt, against a polling consumer
+static void testThreads(void) {
+  static ring_t ring;
+  const uint16_t frames = 60000U;
+  volatile bool done = false;
+
+  std::thread producer([&]() {
+    uint16_t bands[MSGEQ7_BAND_COUNT];
+    uint32_t state = 0x9E3779B9UL;
+    for (uint16_t n = 1; n <= frames; n++) {
+      makeFrame(bands, n);
+      ring.push(bands);
+
+      // a random gap between frames, and on a single core a random hand-over to the
+      // consumer, so the consumer sometimes keeps up and sometimes falls behind
+      uint32_t random = nextRandom(state);
+      for (volatile uint32_t spin = random & 0x3FF; spin > 0; spin--) { }
+      if ((random & 0x3000) == 0) {
+        std::this_thread::yield();
+      }
+    }
+    done = true;
+  });
+
+  uint32_t received = 0;
+  uint32_t torn_frames = 0;
+  uint32_t reordered = 0;
+  uint16_t last = 0;
+  frame_t frame;
+  while (!done || ring.available()) {
+    if (ring.pop(frame)) {
+      torn_frames += torn(frame) ? 1 : 0;
+      reordered += (frame.sequence <= last) ? 1 : 0;
+      last = frame.sequence;
+      received++;
+    }
+    else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  CHECK_EQUAL(torn_frames, 0);
+  CHECK_EQUAL(reordered, 0);
+  CHECK_EQUAL(received + ring.lost() + (frames - last), frames);
+  printf("  threads: %u frames produced, %u received, %u lost\n", frames, received, ring.lost());
+}
+#endif
+
+// host cost of a push and of a pop
+static void benchmark(void) {
+  static ring_t ring;
+  uint16_t bands[MSGEQ7_BAND_COUNT];
+  makeFrame(bands, 1);
+  frame_t frame;
+
+  double push_pop = HostTest::nanosPerCall(1000000UL, [&](uint32_t) {
+    ring.push(bands);
+    ring.pop(frame);
+    HOST_KEEP(frame.band[0]);
+  });
+  double pop_empty = HostTest::nanosPerCall(1000000UL, [&](uint32_t) {
+    HOST_KEEP(ring.pop(frame));
+  });
+  printf("  push + pop %.1f ns, pop of an empty ring %.1f ns (host)\n", push_pop, pop_empty);
+}
+
+int main(void) {
+  testDropOnFull();
+  testInterleaved();
+#if FRAME_RING_THREAD_TEST
+  testThreads();
+#endif
+  benchmark();
+  return HostTest::finish("test_msgeq7_frame_ring");
+}
@@ -0,0 +1,227 @@
+/*
+ * test_msgeq7_onset.cpp - MSGEQ7 Onset Detector Accuracy and Cost on Synthetic Frame Sequences
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "host_test.h"
+#include "../../src/audio/MSGEQ7.h"
+
+HOST_TEST_MAIN();
+
+// a detected beat within this long of a true onset counts as a hit (in milliseconds)
+#define ONSET_TOLERANCE_MILLIS (30U)
+
+struct sequence_t {
+  std::vector<std::vector<uint16_t> > frames;
+  std::vector<uint32_t> timestamps;
+  std::vector<uint32_t> onsets;
+  std::vector<uint32_t> changes;
+};
+
+struct score_t {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t false_beats;
+  uint32_t change_beats;
+};
+
+static uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/*! @brief  Build a frame sequence of kicks over a noisy, slowly varying background
+*
+* @details Levels are on the scale of weighted MSGEQ7 frames (10-bit readings << 3). Each
+*          kick raises the bass bands by `kick` and the mid bands by a quarter of that, then
+*          decays by 1/8 per frame. Every 4 seconds the background level steps up or down,
+*          like a change of section. Frame periods vary between `period_min` and `period_max`
+*          milliseconds, like a main loop that is sometimes busy.
+*/
+static sequence_t makeSequence(const uint32_t seed, const uint32_t duration_millis, 
+                               const uint32_t beat_millis, const uint16_t kick, 
+                               const uint16_t noise, const uint8_t period_min, 
+                               const uint8_t period_max) {
+  sequence_t sequence;
+  uint32_t state = seed;
+  uint32_t now = 0;
+  uint32_t next_onset = beat_millis;
+  uint32_t envelope = 0;
+  while (now < duration_millis) {
+    if ((beat_millis != 0) && (now >= next_onset)) {
+      sequence.onsets.push_back(now);
+      envelope = kick;
+      next_onset += beat_millis;
+    }
+
+    uint32_t background = 800 + ((now / 4000) & 0x01) * 600;
+    if ((now / 4000) != (sequence.timestamps.empty() ? 0 : (sequence.timestamps.back() / 4000))) {
+      sequence.changes.push_back(now);
+    }
+    std::vector<uint16_t> frame(MSGEQ7_BAND_COUNT);
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      uint32_t level = background + (nextRandom(state) % (noise + 1));
+      level += (k < 2) ? envelope : ((k < 4) ? (envelope >> 2) : 0);
+      frame[k] = (level > 8184) ? 8184 : (uint16_t)level;
+    }
+    sequence.frames.push_back(frame);
+    sequence.timestamps.push_back(now);
+
+    envelope -= envelope >> 3;
+    now += period_min + (nextRandom(state) % ((period_max - period_min) + 1));
+  }
+  return sequence;
+}
+
+// true if `timestamp` is within the tolerance after one of `times`
+static bool near(const std::vector<uint32_t> &times, const uint32_t timestamp) {
+  for (size_t k = 0; k < times.size(); k++) {
+    if ((timestamp >= times[k]) && ((timestamp - times[k]) <= ONSET_TOLERANCE_MILLIS)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// beats are matched to the onsets, a beat at a section change is a genuine rise in level
+// so it is counted apart from the false beats
+static score_t score(const sequence_t &sequence, MSGEQ7::OnsetDetector &detector) {
+  score_t result = { 0, 0, 0, 0 };
+  std::vector<bool> matched(sequence.onsets.size(), false);
+  detector.reset();
+  for (size_t n = 0; n < sequence.frames.size(); n++) {
+    if (!detector.update(&sequence.frames[n][0], MSGEQ7_BAND_COUNT * sizeof(uint16_t), 
+                         sequence.timestamps[n])) {
+      continue;
+    }
+    CHECK_EQUAL(detector.lastBeat().timestamp, sequence.timestamps[n]);
+
+    bool hit = false;
+    for (size_t k = 0; (k < sequence.onsets.size()) && !hit; k++) {
+      uint32_t onset = sequence.onsets[k];
+      if (!matched[k] && (sequence.timestamps[n] >= onset) && 
+          ((sequence.timestamps[n] - onset) <= ONSET_TOLERANCE_MILLIS)) {
+        matched[k] = true;
+        hit = true;
+      }
+    }
+    if (hit) {
+      result.hits++;
+    }
+    else if (near(sequence.changes, sequence.timestamps[n])) {
+      result.change_beats++;
+    }
+    else {
+      result.false_beats++;
+    }
+  }
+
+  // onsets in the first history window can't be reported, so they aren't scored
+  uint32_t warm_up = sequence.timestamps[(MSGEQ7_ONSET_HISTORY + 1) % sequence.timestamps.size()];
+  for (size_t k = 0; k < sequence.onsets.size(); k++) {
+    result.misses += (!matched[k] && (sequence.onsets[k] > warm_up)) ? 1 : 0;
+  }
+  return result;
+}
+
+static void report(const char *name, const score_t &result) {
+  uint32_t detected = result.hits + result.false_beats;
+  uint32_t onsets = result.hits + result.misses;
+  printf("  %-34s %3u onsets, %3u hits, %2u missed, %2u false, %2u at section changes "
+         "(precision %.3f, recall %.3f)\n", 
+         name, onsets, result.hits, result.misses, result.false_beats, result.change_beats, 
+         detected ? (double)result.hits / detected : 1.0, 
+         onsets ? (double)result.hits / onsets : 1.0);
+}
+
+// steady kicks with a regular main loop
+static void testSteadyBeat(void) {
+  MSGEQ7::OnsetDetector detector;
+  sequence_t sequence = makeSequence(0x1234567UL, 60000UL, 500, 3000, 150, 10, 10);
+  score_t result = score(sequence, detector);
+  report("120 BPM, 10 ms frames", result);
+  CHECK(result.misses * 50 <= result.hits);
+  CHECK(result.false_beats * 50 <= result.hits);
+}
+
+// faster kicks read by a main loop that is often late
+static void testJitteredFrames(void) {
+  MSGEQ7::OnsetDetector detector;
+  sequence_t sequence = makeSequence(0x89ABCDEUL, 60000UL, 375, 2500, 150, 6, 22);
+  score_t result = score(sequence, detector);
+  report("160 BPM, 6-22 ms frames", result);
+  CHECK(result.misses * 50 <= result.hits);
+  CHECK(result.false_beats * 50 <= result.hits);
+}
+
+// quieter kicks closer to the noise
+static void testQuietBeat(void) {
+  MSGEQ7::OnsetDetector detector;
+  sequence_t sequence = makeSequence(0x0F0F0F0UL, 60000UL, 600, 1200, 150, 10, 10);
+  score_t result = score(sequence, detector);
+  report("100 BPM, quiet kicks", result);
+  CHECK(result.misses * 20 <= result.hits);
+  CHECK(result.false_beats * 20 <= result.hits);
+}
+
+// with twice the noise the default threshold (2x the mean flux) lets noise peaks through,
+// a sensitivity of 3x the mean flux rejects them again
+static void testNoisyBeat(void) {
+  MSGEQ7::OnsetDetector detector;
+  sequence_t sequence = makeSequence(0x1234567UL, 60000UL, 500, 3000, 300, 10, 10);
+  score_t result = score(sequence, detector);
+  report("120 BPM, noisy, default", result);
+
+  detector.configure(48, MSGEQ7_ONSET_MINIMUM_FLUX, MSGEQ7_ONSET_REFRACTORY_MILLI);
+  result = score(sequence, detector);
+  report("120 BPM, noisy, sensitivity 3.0", result);
+  CHECK(result.misses * 50 <= result.hits);
+  CHECK(result.false_beats * 50 <= result.hits);
+}
+
+// background noise and section changes alone report no beats apart from the changes
+static void testNoiseOnly(void) {
+  MSGEQ7::OnsetDetector detector;
+  sequence_t sequence = makeSequence(0x7777777UL, 60000UL, 0, 0, 150, 10, 10);
+  score_t result = score(sequence, detector);
+  report("noise only", result);
+  CHECK(result.false_beats <= 2);
+}
+
+// host cost of one update, which is O(7) whatever the input
+static void benchmark(void) {
+  MSGEQ7::OnsetDetector detector;
+  sequence_t sequence = makeSequence(0x1234567UL, 60000UL, 500, 3000, 150, 10, 10);
+  const size_t count = sequence.frames.size();
+  double per_frame = HostTest::nanosPerCall(1000000UL, [&](uint32_t n) {
+    size_t k = n % count;
+    HOST_KEEP(detector.update(&sequence.frames[k][0], MSGEQ7_BAND_COUNT * sizeof(uint16_t), 
+                              sequence.timestamps[k] + ((n / count) * 60000UL)));
+  });
+  printf("  update() %.1f ns per frame (host)\n", per_frame);
+}
+
+int main(void) {
+  testSteadyBeat();
+  testJitteredFrames();
+  testQuietBeat();
+  testNoisyBeat();
+  testNoiseOnly();
+  benchmark();
+  return HostTest::finish("test_msgeq7_onset");
+}
@@ -0,0 +1,212 @@
+/*
+ * test_msgeq7_sequencer.cpp - MSGEQ7 Non-blocking Sampling Sequencer Timing on a Mocked Clock
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "host_test.h"
+#include "../../src/audio/MSGEQ7.h"
+
+HOST_TEST_MAIN();
+
+using namespace MSGEQ7::MSGEQ7Types;
+
+#define STROBE_PIN  (4U)
+#define RESET_PIN   (5U)
+#define DC_OUT_PIN  (A0)
+
+// main loop granularity between update() calls (in microseconds)
+#define LOOP_MICROS (5U)
+
+// band level presented on DC_OUT, a different level for each strobe window
+static uint16_t bandLevel(uint8_t pin, uint32_t micros) {
+  (void)pin;
+  (void)micros;
+  uint8_t strobes = 0;
+  for (size_t k = 0; k < Host::pin_events.size(); k++) {
+    if ((Host::pin_events[k].pin == STROBE_PIN) && (Host::pin_events[k].value == LOW)) {
+      strobes++;
+    }
+  }
+  return 100U * strobes;
+}
+
+struct frame_timing_t {
+  uint32_t reset_low;
+  uint32_t reset_high;
+  std::vector<uint32_t> strobe_low;
+  std::vector<uint32_t> strobe_high;
+};
+
+static frame_timing_t frameTiming(void) {
+  frame_timing_t timing = { 0, 0, std::vector<uint32_t>(), std::vector<uint32_t>() };
+  for (size_t k = 0; k < Host::pin_events.size(); k++) {
+    const Host::pin_event_t &event = Host::pin_events[k];
+    if (event.pin == RESET_PIN) {
+      if (event.value == LOW) {
+        timing.reset_low = event.micros;
+      }
+      else {
+        timing.reset_high = event.micros;
+      }
+    }
+    else if (event.pin == STROBE_PIN) {
+      if (event.value == LOW) {
+        timing.strobe_low.push_back(event.micros);
+      }
+      else {
+        timing.strobe_high.push_back(event.micros);
+      }
+    }
+  }
+  return timing;
+}
+
+// drive update() from a main loop until a frame completes, returning the longest call
+static uint32_t runFrame(MSGEQ7::MSGEQ7 &eq, uint32_t &calls) {
+  uint32_t longest = 0;
+  calls = 0;
+  bool complete = false;
+  while (!complete && (calls < 100000UL)) {
+    uint32_t start = Host::clock_micros;
+    complete = eq.update();
+    uint32_t duration = Host::clock_micros - start;
+    longest = (duration > longest) ? duration : longest;
+    calls++;
+    Host::advanceMicros(LOOP_MICROS);
+  }
+  return longest;
+}
+
+static void checkStrobeTiming(const frame_timing_t &timing, const uint8_t reads_per_band) {
+  CHECK_EQUAL(timing.strobe_low.size(), MSGEQ7_BAND_COUNT);
+  CHECK_EQUAL(timing.strobe_high.size(), MSGEQ7_BAND_COUNT);
+  CHECK_EQUAL(Host::analog_events.size(), MSGEQ7_BAND_COUNT * reads_per_band);
+  if ((timing.strobe_low.size() != MSGEQ7_BAND_COUNT) || 
+      (timing.strobe_high.size() != MSGEQ7_BAND_COUNT) || 
+      (Host::analog_events.size() != (size_t)(MSGEQ7_BAND_COUNT * reads_per_band))) {
+    return;
+  }
+
+  // RESET is held low for the reset delay before the first strobe
+  CHECK(timing.strobe_low[0] - timing.reset_low >= MSGEQ7_RESET_DELAY_MICROS);
+
+  for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+    // every sample of a band is taken after DC_OUT has settled, and completes
+    // before STROBE is released
+    for (uint8_t n = 0; n < reads_per_band; n++) {
+      uint32_t sample = Host::analog_events[(k * reads_per_band) + n].micros;
+      CHECK(sample - timing.strobe_low[k] >= MSGEQ7_STROBE_SETTLE_MICROS);
+      CHECK(timing.strobe_high[k] - sample >= Host::analog_read_micros);
+    }
+
+    // STROBE is held high before the next band, and before RESET is raised
+    uint32_t next = (k < (MSGEQ7_BAND_COUNT - 1)) ? timing.strobe_low[k + 1] : timing.reset_high;
+    CHECK(next - timing.strobe_high[k] >= MSGEQ7_STROBE_HOLD_MICROS);
+  }
+}
+
+// the strobe/reset sequence meets the MSGEQ7 timing, one band per strobe window
+static void testBlockingSequence(const uint32_t clock_start) {
+  Host::reset();
+  Host::clock_micros = clock_start;
+  Host::analog_source = &bandLevel;
+
+  MSGEQ7::MSGEQ7 eq(STROBE_PIN, DC_OUT_PIN, RESET_PIN, false);
+  eq.init();
+  Host::pin_events.clear();
+
+  uint32_t calls = 0;
+  uint32_t start = Host::clock_micros;
+  uint32_t longest = runFrame(eq, calls);
+  uint32_t frame_micros = Host::clock_micros - start;
+
+  frame_timing_t timing = frameTiming();
+  checkStrobeTiming(timing, 1);
+
+  // no call blocks for longer than one analogRead(), the rest of the frame is free
+  CHECK(longest <= Host::analog_read_micros + (2 * Host::micros_call_cost));
+  uint32_t minimum = MSGEQ7_RESET_DELAY_MICROS + (MSGEQ7_BAND_COUNT * 
+                     (MSGEQ7_STROBE_SETTLE_MICROS + MSGEQ7_ANALOGREAD_MICROS + MSGEQ7_STROBE_HOLD_MICROS));
+  CHECK(frame_micros >= minimum);
+  CHECK(frame_micros <= minimum + (16 * (LOOP_MICROS + (2 * Host::micros_call_cost))));
+
+  // the completed frame holds the weighted level of each strobe window
+  frame_t frame;
+  CHECK(eq.available());
+  CHECK(eq.getFrame(frame));
+  for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+    uint16_t expected = MSGEQ7::weightBand((uint16_t)((100U * (k + 1)) << 3), k, 
+                                           &MSGEQ7::Weighting::ISO226_60Phon);
+    CHECK_EQUAL(frame.band[k], expected);
+  }
+  CHECK_EQUAL(frame.sequence, 1);
+
+  printf("  blocking, clock from 0x%08X: frame %u us, %u update() calls, longest call %u us\n", 
+         clock_start, frame_micros, calls, longest);
+}
+
+// oversampling takes every sample of a band inside its strobe window
+static void testOversampledSequence(void) {
+  Host::reset();
+  Host::analog_source = &bandLevel;
+
+  MSGEQ7::MSGEQ7 eq(STROBE_PIN, DC_OUT_PIN, RESET_PIN, false, ADC_OVERSAMPLED);
+  eq.init();
+  Host::pin_events.clear();
+
+  uint32_t calls = 0;
+  uint32_t longest = runFrame(eq, calls);
+  checkStrobeTiming(frameTiming(), MSGEQ7_OVERSAMPLE_COUNT);
+  CHECK(longest <= (MSGEQ7_OVERSAMPLE_COUNT * Host::analog_read_micros) + (2 * Host::micros_call_cost));
+
+  printf("  oversampled x%u: %u update() calls, longest call %u us\n", 
+         MSGEQ7_OVERSAMPLE_COUNT, calls, longest);
+}
+
+// read() samples a whole new frame even if update() already queued frames
+static void testReadIsFresh(void) {
+  Host::reset();
+  MSGEQ7::MSGEQ7 eq(STROBE_PIN, DC_OUT_PIN, RESET_PIN, false);
+  eq.init();
+  eq.setWeighting(nullptr);
+
+  // queue a stale frame, and leave another part way through
+  Host::analog_level = 1;
+  uint32_t calls = 0;
+  runFrame(eq, calls);
+  for (uint8_t k = 0; k < 20; k++) {
+    eq.update();
+    Host::advanceMicros(LOOP_MICROS);
+  }
+
+  Host::analog_level = 2;
+  Host::analog_events.clear();
+  uint16_t levels[MSGEQ7_BAND_COUNT];
+  eq.read(levels, sizeof(levels));
+  for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+    CHECK_EQUAL(levels[k], 2U << 3);
+  }
+  CHECK(Host::analog_events.size() >= MSGEQ7_BAND_COUNT);
+  CHECK(!eq.available());
+}
+
+int main(void) {
+  testBlockingSequence(0UL);
+  testBlockingSequence(0xFFFFFE00UL);   // micros() wraps part way through the frame
+  testOversampledSequence();
+  testReadIsFresh();
+  return HostTest::finish("test_msgeq7_sequencer");
+}
@@ -0,0 +1,117 @@
+/*
+ * test_msgeq7_weighting.cpp - MSGEQ7 Q8.8 Band Weighting against the Original Shift Chain
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "host_test.h"
+#include "../../src/audio/MSGEQ7.h"
+#include <math.h>
+
+HOST_TEST_MAIN();
+
+using namespace MSGEQ7::MSGEQ7Types;
+
+// the loudness adjustment MSGEQ7::read() applied after the full read before the
+// weighting tables, on band levels pre-shifted by << 3
+static void shiftChain(uint16_t read_array[]) {
+  read_array[0] = read_array[0] >> 3;   //   63 Hz
+  read_array[1] = read_array[1] >> 1;   //  160 Hz
+  read_array[2] = read_array[2] >> 0;   //  400 Hz
+  read_array[3] = read_array[3] << 0;   // 1000 Hz
+  read_array[4] = read_array[4] << 0;   // 2500 Hz
+  read_array[5] = read_array[5] >> 1;   // 6250 Hz
+  read_array[6] = read_array[6] >> 2;   //16000 Hz
+}
+
+static void weightFrame(uint16_t read_array[], const band_weights_t *weights) {
+  for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+    read_array[k] = MSGEQ7::weightBand(read_array[k], k, weights);
+  }
+}
+
+// the default table gives the same levels as the shift chain for every ADC reading
+static void testDefaultMatchesShiftChain(void) {
+  uint32_t mismatches = 0;
+  for (uint16_t level = 0; level < 1024; level++) {
+    uint16_t shifted[MSGEQ7_BAND_COUNT];
+    uint16_t weighted[MSGEQ7_BAND_COUNT];
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      shifted[k] = (uint16_t)(level << 3);
+      weighted[k] = (uint16_t)(level << 3);
+    }
+    shiftChain(shifted);
+    weightFrame(weighted, &MSGEQ7::Weighting::ISO226_60Phon);
+    mismatches += (memcmp(shifted, weighted, sizeof(shifted)) != 0) ? 1 : 0;
+  }
+  CHECK_EQUAL(mismatches, 0);
+}
+
+// no table leaves the pre-shifted level unchanged, and large gains saturate
+static void testUnweightedAndSaturation(void) {
+  CHECK_EQUAL(MSGEQ7::weightBand(1023U << 3, 0, nullptr), 1023U << 3);
+
+  static const band_weights_t boost = {{ 
+    MSGEQ7::gainToQ8_8(16.0f), 256, 256, 256, 256, 256, 256 
+  }};
+  CHECK_EQUAL(MSGEQ7::weightBand(1023U << 3, 0, &boost), 0xFFFF);
+  CHECK_EQUAL(MSGEQ7::weightBand(100, 0, &boost), 1600);
+  CHECK_EQUAL(MSGEQ7::weightBand(100, 1, &boost), 100);
+}
+
+// compile-time dB tables are within one Q8.8 step of 10^(dB/20)
+static void testDecibelTables(void) {
+  static_assert(MSGEQ7::dBToQ8_8(0.0f) == 256, "0 dB is unity gain");
+
+  int worst = 0;
+  for (int tenths = -300; tenths <= 120; tenths += 5) {
+    float dB = tenths / 10.0f;
+    int expected = (int)lround(256.0 * pow(10.0, dB / 20.0));
+    int error = abs((int)MSGEQ7::dBToQ8_8(dB) - expected);
+    worst = (error > worst) ? error : worst;
+  }
+  CHECK(worst <= 1);
+  printf("  dBToQ8_8() from -30 dB to +12 dB: worst error %d Q8.8 step\n", worst);
+}
+
+// host cost of weighting a frame, against the shift chain it replaced
+static void benchmark(void) {
+  static uint16_t frame[MSGEQ7_BAND_COUNT];
+  const band_weights_t *weights = &MSGEQ7::Weighting::ISO226_60Phon;
+
+  double shift = HostTest::nanosPerCall(2000000UL, [&](uint32_t n) {
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      frame[k] = (uint16_t)((n + k) << 3);
+    }
+    shiftChain(frame);
+    HOST_KEEP(frame[0]);
+  });
+  double table = HostTest::nanosPerCall(2000000UL, [&](uint32_t n) {
+    for (uint8_t k = 0; k < MSGEQ7_BAND_COUNT; k++) {
+      frame[k] = (uint16_t)((n + k) << 3);
+    }
+    weightFrame(frame, weights);
+    HOST_KEEP(frame[0]);
+  });
+  printf("  per frame: shift chain %.1f ns, Q8.8 table %.1f ns (host)\n", shift, table);
+}
+
+int main(void) {
+  testDefaultMatchesShiftChain();
+  testUnweightedAndSaturation();
+  testDecibelTables();
+  benchmark();
+  return HostTest::finish("test_msgeq7_weighting");
+}
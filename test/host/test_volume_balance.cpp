@@ -0,0 +1,125 @@
+/*
+ * test_volume_balance.cpp - DS1882 and AD5290 Volume and Balance on Fake Buses
+ * Copyright (c) 2026 Winry R. Litwa-Vulcu. All rights reserved.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include "host_test.h"
+#include "../../src/audio/VolumeBalance.h"
+
+HOST_TEST_MAIN();
+
+#define ENABLE_PIN      (5U)
+#define CHIP_SELECT_PIN (10U)
+#define CHAIN_DEVICES   (4U)
+
+// the quieter side of the balance is attenuated by the offset, and clamps at mute
+static void testChannelAttenuation(void) {
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(10, 0, false), 10);
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(10, 0, true), 10);
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(10, 3, false), 13);
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(10, 3, true), 10);
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(10, -3, false), 10);
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(10, -3, true), 13);
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(60, 127, false), VOLUMEBALANCE_MUTE_ATTENUATION);
+  CHECK_EQUAL(VolumeBalance::channelAttenuation(60, -128, true), VOLUMEBALANCE_MUTE_ATTENUATION);
+}
+
+// the taper table is 255 * 10^(-dB / 20) rounded, and the mute attenuation is wiper 0
+static void testTaper(void) {
+  uint32_t mismatches = 0;
+  for (uint8_t dB = 0; dB < VOLUMEBALANCE_MUTE_ATTENUATION; dB++) {
+    uint8_t expected = (uint8_t)lround(255.0 * pow(10.0, -dB / 20.0));
+    if (VolumeBalance::attenuationToWiper(dB) != expected) {
+      mismatches++;
+      printf("  %u dB: wiper %u, expected %u\n", dB, VolumeBalance::attenuationToWiper(dB), expected);
+    }
+  }
+  CHECK_EQUAL(mismatches, 0);
+  CHECK_EQUAL(VolumeBalance::attenuationToWiper(VOLUMEBALANCE_MUTE_ATTENUATION), AD5290_MINIMUM_WIPER_VALUE);
+  CHECK_EQUAL(VolumeBalance::attenuationToWiper(255), AD5290_MINIMUM_WIPER_VALUE);
+}
+
+// both potentiometers in one transaction, and only the ones that changed
+static void testDS1882(void) {
+  Host::reset();
+  DS1882::DS1882 pot(DS1882_DEFAULT_I2CADDR, ENABLE_PIN, &Wire);
+  CHECK(pot.init());
+  VolumeBalance::DS1882Balance balance(pot);
+  Wire.transactions.clear();
+
+  CHECK(balance.set(10, 3));
+  CHECK_EQUAL(Wire.transactions.size(), 1);
+  CHECK_EQUAL(Wire.transactions[0].address, DS1882_DEFAULT_I2CADDR);
+  CHECK_BYTES(Wire.transactions[0].data, { DS1882_COMMAND_POT0 + 13, DS1882_COMMAND_POT1 + 10 });
+
+  // moving the balance to the other side changes both channels
+  CHECK(balance.set(10, -2));
+  CHECK_EQUAL(Wire.transactions.size(), 2);
+  CHECK_BYTES(Wire.transactions[1].data, { DS1882_COMMAND_POT0 + 10, DS1882_COMMAND_POT1 + 12 });
+
+  // a master change with the right channel already there only writes the left channel
+  CHECK(balance.set(12, 0));
+  CHECK_EQUAL(Wire.transactions.size(), 3);
+  CHECK_BYTES(Wire.transactions[2].data, { DS1882_COMMAND_POT0 + 12 });
+
+  CHECK(balance.set(12, 0));
+  CHECK_EQUAL(Wire.transactions.size(), 3);
+
+  CHECK(balance.set(60, 10));
+  CHECK_EQUAL(Wire.transactions.size(), 4);
+  CHECK_BYTES(Wire.transactions[3].data, 
+              { DS1882_COMMAND_POT0 + VOLUMEBALANCE_MUTE_ATTENUATION, DS1882_COMMAND_POT1 + 60 });
+}
+
+// the whole chain in one SPI transaction, left channels at even positions
+static void testAD5290(void) {
+  Host::reset();
+  SPI.setChain(CHAIN_DEVICES, 0xAA);
+  AD5290::AD5290<CHAIN_DEVICES> chain(CHIP_SELECT_PIN, AD5290_SPI_SPEEDMAXIMUM);
+  CHECK(chain.init());
+  chain.setVerify(true);
+  VolumeBalance::AD5290Balance<CHAIN_DEVICES> balance(chain);
+  SPI.transactions.clear();
+  uint32_t begun = SPI.transactions_begun;
+
+  // 10 dB is wiper 81 and 12 dB is wiper 64
+  CHECK(balance.set(10, -2));
+  CHECK_EQUAL(SPI.transactions_begun - begun, 1);
+  CHECK_EQUAL(SPI.transactions.size(), 1);
+  CHECK_BYTES(SPI.transactions[0], { 81, 64, 81, 64 });
+  for (uint8_t k = 0; k < CHAIN_DEVICES; k++) {
+    CHECK_EQUAL(chain.getChannel(k), (k & 0x01) ? 64 : 81);
+  }
+
+  // nothing changed so nothing is shifted
+  CHECK(balance.set(10, -2));
+  CHECK_EQUAL(SPI.transactions_begun - begun, 1);
+
+  // muting the left channels
+  CHECK(balance.set(0, 127));
+  CHECK_EQUAL(SPI.transactions_begun - begun, 2);
+  CHECK_BYTES(SPI.transactions[1], { 0, 255, 0, 255 });
+  CHECK_EQUAL(chain.verifyErrors(), 0);
+}
+
+int main(void) {
+  testChannelAttenuation();
+  testTaper();
+  testDS1882();
+  testAD5290();
+  return HostTest::finish("test_volume_balance");
+}